@@ -0,0 +1,48 @@
+#pragma once
+#include <stdexcept>
+#include "GridCell.h"
+
+// 棋盘配置：生成轨迹时行、列坐标的取值范围[minCoord, maxCoord]
+// 生成器、越界检查和界面共用同一份配置，默认与原来的-15到15一致
+// 复杂模式的轨迹以六边形轴坐标存放，生成时q、r的范围由棋盘换算得到（见GameObject::getBoard）
+class BoardConfig {
+private:
+    int minCoord;
+    int maxCoord;
+
+public:
+    // 合成后的最终轨迹最远可达棋盘范围的两倍，坐标又以16位存放，因此范围限制在±16383以内
+    static const int LIMIT = 16383;
+    static const int DEFAULT_MIN_COORD = -15;
+    static const int DEFAULT_MAX_COORD = 15;
+
+    // 构造函数，范围无效时抛出invalid_argument
+    BoardConfig(int minValue = DEFAULT_MIN_COORD, int maxValue = DEFAULT_MAX_COORD)
+        : minCoord(minValue), maxCoord(maxValue) {
+        if (minValue > maxValue || minValue < -LIMIT || maxValue > LIMIT) {
+            throw std::invalid_argument("BoardConfig: invalid coordinate range");
+        }
+    }
+
+    // 以原点为中心、边长为side的棋盘
+    static BoardConfig centered(int side) {
+        return BoardConfig(-(side / 2), side - side / 2 - 1);
+    }
+
+    int getMinCoord() const { return minCoord; }
+    int getMaxCoord() const { return maxCoord; }
+
+    // 边长（格数）
+    int getSide() const { return maxCoord - minCoord + 1; }
+
+    // 单元格是否在棋盘内
+    bool contains(const GridCell& cell) const {
+        return static_cast<unsigned>(cell.getRow() - minCoord) <= static_cast<unsigned>(maxCoord - minCoord) &&
+               static_cast<unsigned>(cell.getCol() - minCoord) <= static_cast<unsigned>(maxCoord - minCoord);
+    }
+
+    bool operator==(const BoardConfig& other) const {
+        return minCoord == other.minCoord && maxCoord == other.maxCoord;
+    }
+    bool operator!=(const BoardConfig& other) const { return !(*this == other); }
+};
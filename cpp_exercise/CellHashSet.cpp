@@ -0,0 +1,98 @@
+#include "CellHashSet.h"
+#include <algorithm>
+using namespace std;
+
+namespace {
+const size_t INITIAL_CAPACITY = 16;
+}
+
+CellHashSet::CellHashSet() : used(0) {
+    // 第一次插入时才分配
+}
+
+size_t CellHashSet::hashKey(uint32_t key) {
+    // 乘法散列，取高位
+    return static_cast<size_t>((static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+size_t CellHashSet::findSlot(uint32_t key) const {
+    size_t mask = slots.size() - 1;
+    size_t index = hashKey(key) & mask;
+    while (slots[index].count != 0 && slots[index].key != key) {
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+void CellHashSet::grow() {
+    vector<Slot> old;
+    old.swap(slots);
+    slots.assign(old.empty() ? INITIAL_CAPACITY : old.size() * 2, Slot{0, 0});
+    for (const Slot& slot : old) {
+        if (slot.count != 0) {
+            slots[findSlot(slot.key)] = slot;
+        }
+    }
+}
+
+uint32_t CellHashSet::insert(const GridCell& cell) {
+    // 装载因子保持在1/2以下
+    if ((used + 1) * 2 > slots.size()) {
+        grow();
+    }
+    uint32_t key = cell.getPacked();
+    Slot& slot = slots[findSlot(key)];
+    if (slot.count == 0) {
+        slot.key = key;
+        used++;
+    }
+    return ++slot.count;
+}
+
+bool CellHashSet::erase(const GridCell& cell) {
+    if (used == 0) {
+        return false;
+    }
+    size_t mask = slots.size() - 1;
+    size_t index = findSlot(cell.getPacked());
+    if (slots[index].count == 0) {
+        return false;
+    }
+    if (--slots[index].count != 0) {
+        return true;
+    }
+    used--;
+    // 向后移位删除：把后面探测链上的元素前移填补空位，不留墓碑
+    size_t hole = index;
+    size_t next = (hole + 1) & mask;
+    while (slots[next].count != 0) {
+        size_t home = hashKey(slots[next].key) & mask;
+        // home不在(hole, next]之间时，该元素可以移到hole
+        bool movable = (next > hole) ? (home <= hole || home > next) : (home <= hole && home > next);
+        if (movable) {
+            slots[hole] = slots[next];
+            slots[next].count = 0;
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    return true;
+}
+
+bool CellHashSet::contains(const GridCell& cell) const {
+    if (used == 0) {
+        return false;
+    }
+    return slots[findSlot(cell.getPacked())].count != 0;
+}
+
+size_t CellHashSet::size() const {
+    return used;
+}
+
+void CellHashSet::clear() {
+    if (used != 0) {
+        fill(slots.begin(), slots.end(), Slot{0, 0});
+        used = 0;
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "GridCell.h"
+
+// 网格单元的开放寻址哈希集合（线性探测），键为打包后的32位坐标
+// 每个键带一个计数，允许同一单元格重复加入；内存与加入的单元格数成正比，与棋盘大小无关
+class CellHashSet {
+private:
+    struct Slot {
+        uint32_t key;
+        uint32_t count;  // 0表示空槽
+    };
+
+    std::vector<Slot> slots;  // 容量为2的幂
+    size_t used;              // 非空槽数量
+
+    static size_t hashKey(uint32_t key);
+    size_t findSlot(uint32_t key) const;  // 返回键所在的槽或应插入的空槽
+    void grow();
+
+public:
+    // 构造函数
+    CellHashSet();
+
+    // 加入一个单元格，返回加入后的计数
+    uint32_t insert(const GridCell& cell);
+
+    // 移除一个单元格的一次计数，计数为0时删除；单元格不存在返回false
+    bool erase(const GridCell& cell);
+
+    // 判断单元格是否在集合中
+    bool contains(const GridCell& cell) const;
+
+    // 不同单元格的数量
+    size_t size() const;
+
+    // 清空集合（保留已分配的容量）
+    void clear();
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include "GridCell.h"
+
+// 连续网格单元的只读视图（类似std::span），不拥有数据
+// 视图在源轨迹被修改后失效
+class CellSpan {
+private:
+    const GridCell* ptr;
+    size_t count;
+
+public:
+    typedef const GridCell* iterator;
+
+    constexpr CellSpan() : ptr(nullptr), count(0) {}
+    constexpr CellSpan(const GridCell* data, size_t size) : ptr(data), count(size) {}
+
+    constexpr const GridCell* data() const { return ptr; }
+    constexpr size_t size() const { return count; }
+    constexpr bool empty() const { return count == 0; }
+
+    // 不做边界检查
+    constexpr const GridCell& operator[](size_t index) const { return ptr[index]; }
+    constexpr const GridCell& front() const { return ptr[0]; }
+    constexpr const GridCell& back() const { return ptr[count - 1]; }
+
+    constexpr iterator begin() const { return ptr; }
+    constexpr iterator end() const { return ptr + count; }
+
+    // 子视图，调用方保证offset+length不越界
+    constexpr CellSpan subspan(size_t offset, size_t length) const { return CellSpan(ptr + offset, length); }
+    constexpr CellSpan subspan(size_t offset) const { return CellSpan(ptr + offset, count - offset); }
+    constexpr CellSpan first(size_t length) const { return CellSpan(ptr, length); }
+    constexpr CellSpan last(size_t length) const { return CellSpan(ptr + count - length, length); }
+};
@@ -0,0 +1,168 @@
+#include "CompactTrajectory.h"
+#include "Topology.h"
+#include <stdexcept>
+using namespace std;
+
+CompactTrajectory::CompactTrajectory(MoveSet moveSet)
+    : moveSet(static_cast<uint8_t>(moveSet)), cellCount(0) {
+    // 四方向2位一步，六方向和八方向3位一步；3位编码每字只放21步，保证不跨字
+    bitsPerStep = (moveSet == FOUR_DIRECTIONS) ? 2 : 3;
+    stepsPerWord = 64 / bitsPerStep;
+}
+
+const GridCell* CompactTrajectory::directionTable(MoveSet moveSet) {
+    switch (moveSet) {
+        case HEX_DIRECTIONS: return HexTopology::DIRECTIONS;
+        case KING_DIRECTIONS: return KingTopology::DIRECTIONS;
+        default: return SquareTopology::DIRECTIONS;
+    }
+}
+
+int CompactTrajectory::directionCount(MoveSet moveSet) {
+    switch (moveSet) {
+        case HEX_DIRECTIONS: return HexTopology::DIRECTION_COUNT;
+        case KING_DIRECTIONS: return KingTopology::DIRECTION_COUNT;
+        default: return SquareTopology::DIRECTION_COUNT;
+    }
+}
+
+CompactTrajectory CompactTrajectory::encode(const GridCell* cells, size_t count, MoveSet moveSet) {
+    CompactTrajectory result(moveSet);
+    if (count == 0) {
+        return result;
+    }
+    result.setStart(cells[0]);
+    result.words.reserve((count - 1) / result.stepsPerWord + 1);
+
+    const GridCell* table = directionTable(moveSet);
+    int directions = directionCount(moveSet);
+    for (size_t i = 1; i < count; i++) {
+        // 根据相邻单元格之差查找方向编号
+        GridCell delta = cells[i] - cells[i - 1];
+        int direction = -1;
+        for (int d = 0; d < directions; d++) {
+            if (table[d] == delta) {
+                direction = d;
+                break;
+            }
+        }
+        if (direction < 0) {
+            throw std::invalid_argument("Trajectory step is not a unit move");
+        }
+        result.addDirection(direction);
+    }
+    return result;
+}
+
+CompactTrajectory CompactTrajectory::encode(const std::vector<GridCell>& cells, MoveSet moveSet) {
+    return encode(cells.data(), cells.size(), moveSet);
+}
+
+CompactTrajectory CompactTrajectory::encode(const Trajectory& trajectory, MoveSet moveSet) {
+    return encode(trajectory.getCells().data(), trajectory.getLength(), moveSet);
+}
+
+std::vector<GridCell> CompactTrajectory::decode() const {
+    std::vector<GridCell> cells;
+    if (cellCount == 0) {
+        return cells;
+    }
+    cells.reserve(cellCount);
+    const GridCell* table = directionTable(getMoveSet());
+    GridCell current = start;
+    cells.push_back(current);
+    for (size_t step = 0; step + 1 < cellCount; step++) {
+        current = current + table[getDirection(step)];
+        cells.push_back(current);
+    }
+    return cells;
+}
+
+Trajectory CompactTrajectory::toTrajectory() const {
+    Trajectory trajectory;
+    for (const GridCell& cell : decode()) {
+        trajectory.addCell(cell);
+    }
+    return trajectory;
+}
+
+void CompactTrajectory::setStart(const GridCell& cell) {
+    clear();
+    start = cell;
+    endCell = cell;
+    cellCount = 1;
+}
+
+void CompactTrajectory::addDirection(int direction) {
+    if (direction < 0 || direction >= directionCount(getMoveSet())) {
+        throw std::invalid_argument("Invalid direction");
+    }
+    if (cellCount == 0) {
+        // 没有设置起点时默认从(0,0)出发
+        setStart(GridCell(0, 0));
+    }
+    size_t step = cellCount - 1;
+    size_t word = step / stepsPerWord;
+    size_t shift = (step % stepsPerWord) * bitsPerStep;
+    if (word == words.size()) {
+        words.push_back(0);
+    }
+    words[word] |= static_cast<uint64_t>(direction) << shift;
+    cellCount++;
+
+    endCell = endCell + directionTable(getMoveSet())[direction];
+    if ((cellCount - 1) % CHECKPOINT_INTERVAL == 0) {
+        checkpoints.push_back(endCell);
+    }
+}
+
+size_t CompactTrajectory::getLength() const {
+    return cellCount;
+}
+
+size_t CompactTrajectory::getStepCount() const {
+    return cellCount == 0 ? 0 : cellCount - 1;
+}
+
+int CompactTrajectory::getDirection(size_t step) const {
+    if (step >= getStepCount()) {
+        throw std::out_of_range("Step out of range");
+    }
+    uint64_t word = words[step / stepsPerWord];
+    size_t shift = (step % stepsPerWord) * bitsPerStep;
+    return static_cast<int>((word >> shift) & ((uint64_t(1) << bitsPerStep) - 1));
+}
+
+GridCell CompactTrajectory::getCell(size_t index) const {
+    if (index >= cellCount) {
+        throw std::out_of_range("Index out of range");
+    }
+    // 从最近的检查点开始回放，最多CHECKPOINT_INTERVAL-1步
+    size_t checkpoint = index / CHECKPOINT_INTERVAL;
+    GridCell current = checkpoint == 0 ? start : checkpoints[checkpoint - 1];
+    const GridCell* table = directionTable(getMoveSet());
+    for (size_t step = checkpoint * CHECKPOINT_INTERVAL; step < index; step++) {
+        current = current + table[getDirection(step)];
+    }
+    return current;
+}
+
+GridCell CompactTrajectory::getStart() const {
+    return start;
+}
+
+CompactTrajectory::MoveSet CompactTrajectory::getMoveSet() const {
+    return static_cast<MoveSet>(moveSet);
+}
+
+size_t CompactTrajectory::getPayloadBytes() const {
+    return words.size() * sizeof(uint64_t) + checkpoints.size() * sizeof(GridCell);
+}
+
+void CompactTrajectory::clear() {
+    words.clear();
+    checkpoints.clear();
+    start = GridCell(0, 0);
+    endCell = start;
+    cellCount = 0;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "GridCell.h"
+#include "Trajectory.h"
+
+// 方向编码的紧凑轨迹：只保存起点和每一步的方向编号
+// 四方向每步2位，六方向和八方向每步3位，用于大量存储谜题、回放和预测
+class CompactTrajectory {
+public:
+    // 轨迹使用的移动方向集合
+    enum MoveSet {
+        FOUR_DIRECTIONS = 0, // 简单模式，对应four_directions
+        HEX_DIRECTIONS = 1,  // 复杂模式，对应hex_directions
+        KING_DIRECTIONS = 2  // 八方向，对应KingTopology
+    };
+
+    // 每隔多少步保存一个绝对坐标，随机访问最多回放这么多步
+    static const size_t CHECKPOINT_INTERVAL = 128;
+
+private:
+    GridCell start;                    // 起点
+    GridCell endCell;                  // 终点，追加步骤时使用
+    uint8_t moveSet;                   // MoveSet
+    uint8_t bitsPerStep;               // 每步占用的位数
+    uint8_t stepsPerWord;              // 每个64位字容纳的步数（编码不跨字）
+    uint32_t cellCount;                // 单元格数量（步数+1，空轨迹为0）
+    std::vector<uint64_t> words;       // 方向编码
+    std::vector<GridCell> checkpoints; // 第k*CHECKPOINT_INTERVAL步处的坐标
+
+    static const GridCell* directionTable(MoveSet moveSet);
+    static int directionCount(MoveSet moveSet);
+
+public:
+    // 构造函数
+    CompactTrajectory(MoveSet moveSet = FOUR_DIRECTIONS);
+
+    // 由单元格序列编码，相邻单元格之差必须是所选方向集合中的一步，否则抛出invalid_argument
+    static CompactTrajectory encode(const GridCell* cells, size_t count, MoveSet moveSet);
+    static CompactTrajectory encode(const std::vector<GridCell>& cells, MoveSet moveSet);
+    static CompactTrajectory encode(const Trajectory& trajectory, MoveSet moveSet);
+
+    // 还原为单元格序列
+    std::vector<GridCell> decode() const;
+    Trajectory toTrajectory() const;
+
+    // 设置起点（清空已有步骤）
+    void setStart(const GridCell& cell);
+
+    // 追加一步
+    void addDirection(int direction);
+
+    // 获取单元格数量（与Trajectory::getLength一致，包含起点）
+    size_t getLength() const;
+
+    // 获取步数
+    size_t getStepCount() const;
+
+    // 获取第step步的方向编号
+    int getDirection(size_t step) const;
+
+    // 随机访问第index个单元格，越界抛出out_of_range
+    GridCell getCell(size_t index) const;
+
+    // 获取起点
+    GridCell getStart() const;
+
+    // 获取方向集合
+    MoveSet getMoveSet() const;
+
+    // 编码数据实际占用的字节数（不含对象本身）
+    size_t getPayloadBytes() const;
+
+    // 清空轨迹
+    void clear();
+};
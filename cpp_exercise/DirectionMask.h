@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include "RandomEngine.h"
+
+// 方向掩码（每个方向占一位，最多32个方向）的位运算，GameObject与PermSampler共用
+namespace DirectionMask {
+
+// 置位的个数
+inline int countBits(uint32_t x) {
+#if defined(__GNUC__)
+    return __builtin_popcount(x);
+#else
+    x = x - ((x >> 1) & 0x55555555u);
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    return static_cast<int>((((x + (x >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24);
+#endif
+}
+
+// 最低置位的下标，x不能为0
+inline int lowestBit(uint32_t x) {
+#if defined(__GNUC__)
+    return __builtin_ctz(x);
+#else
+    int index = 0;
+    while ((x & 1u) == 0) {
+        x >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+// 在置位中均匀随机选取一个：先随机决定第k个，再去掉最低的k个置位，mask不能为0
+inline int pickBit(RandomEngine& random, uint32_t mask) {
+    int k = random.nextInt(countBits(mask));
+    for (; k > 0; k--) {
+        mask &= mask - 1;
+    }
+    return lowestBit(mask);
+}
+
+} // namespace DirectionMask
@@ -0,0 +1,47 @@
+#pragma once
+#include "GridCell.h"
+#include "HexCell.h"
+
+// 生成器、编码轨迹和界面共用的移动方向表
+
+// 四方向移动（简单模式）
+constexpr GridCell four_directions[4] = {
+    GridCell(-1, 0),
+    GridCell(0, 1),
+    GridCell(0, -1),
+    GridCell(1, 0)
+};
+
+// 六方向移动（复杂模式）：六边形轴坐标(q, r)的单位方向，存放方式与HexCell::toCell一致
+// 依次为上、左上、左下、下、右下、右上，相反方向的下标相差3
+constexpr GridCell hex_directions[6] = {
+    HexCell::direction(0).toCell(),
+    HexCell::direction(1).toCell(),
+    HexCell::direction(2).toCell(),
+    HexCell::direction(3).toCell(),
+    HexCell::direction(4).toCell(),
+    HexCell::direction(5).toCell()
+};
+static_assert(HexCell::direction(0).toOffset() == GridCell(-2, 0) && HexCell::direction(4).toOffset() == GridCell(1, 3),
+              "六方向在屏幕上的偏移与原有布局不一致");
+
+// 复杂模式下绘制六边形轮廓的8个屏幕偏移（围绕换算后的单元格中心）
+constexpr GridCell hex_point[8] = {
+    GridCell(0, -2),
+    GridCell(0, 2),
+    GridCell(-1, 1),
+    GridCell(-1, -1),
+    GridCell(1, 1),
+    GridCell(1, -1),
+    GridCell(-1, 0),
+    GridCell(1, 0)
+};
+
+const int UP = 0;
+const int RIGHT = 1;
+const int LEFT = 2;
+const int DOWN = 3;
+const int UP_RIGHT = 5;
+const int DOWN_RIGHT = 4;
+const int DOWN_LEFT = 2;
+const int UP_LEFT = 1;
@@ -4,6 +4,9 @@
 #include <algorithm>
 #include <sstream>
 #include<cmath>
+#include <stdexcept>
+#include <unordered_set>
+#include <cctype>
 using namespace std;
 const int step=5;
 
@@ -13,6 +16,35 @@ GameManager::GameManager()
       currentRound(0), totalRounds(2), isLoggedIn(false) {
     // 初始化GameManager对象
     // 加载用户数据
+    puzzleDifficulty = ANY_DIFFICULTY;
+    topology3 = TOPOLOGY3_FACE;
+    prefetchRunning = false;
+    prefetchTopology = TOPOLOGY_SQUARE;
+    prefetchSteps = gameSteps;
+    prefetchIndex = 0;
+    setSeed(RandomEngine::seedFromClock());
+    // 题库只做映射，不读取内容，启动耗时与题库大小无关
+    loadPuzzleBank(puzzleBankFile);
+}
+
+GameManager::~GameManager() {
+    stopPrefetch();
+    saveSeenPuzzles();
+}
+
+void GameManager::setSeed(uint64_t seed) {
+    // 工作线程正在使用prefetchSeed，先停下来，已生成的谜题属于旧种子，一并丢弃
+    bool wasPrefetching = stopPrefetch();
+    sessionSeed = seed;
+    RandomEngine base(seed);
+    objectA.setRandomEngine(base.split());
+    object3D.setRandomEngine(base.split());
+    bankRandom = base.split();
+    prefetchSeed = base.split().next();
+    nextPuzzleIndex = 0;
+    if (wasPrefetching) {
+        startPrefetch();
+    }
 }
 
 
@@ -24,7 +56,7 @@ void GameManager::initializeGame(GameMode mode, string username1, string usernam
     
     // 根据游戏模式设置玩家数量
     players.clear();
-    if (mode == SIMPLE_SINGLE || mode == COMPLEX_SINGLE) {
+    if (mode == SIMPLE_SINGLE || mode == COMPLEX_SINGLE || mode == THREE_D_SINGLE) {
         // 单人模式只有一个玩家
         players.push_back(Player(username1));
         currentPlayerIndex = 0; // 确保单人模式下玩家索引设置为0
@@ -43,14 +75,34 @@ void GameManager::initializeGame(GameMode mode, string username1, string usernam
     if (mode == TIME_BASED_MODE) {
         gameSteps = 10;  // 计时模式使用较少步数
         totalRounds = TIMED_MODE_ROUNDS;  // 设置计时模式回合数
+    } else if (mode == THREE_D_SINGLE) {
+        gameSteps = THREE_D_MODE_STEPS;
     } else {
         gameSteps = 10;  // 标准模式步数
     }
+
+    // 按模式和步数选择生成策略
+    applyStrategy();
     
     // 生成游戏数据
     generateGameData();
 }
 
+void GameManager::applyStrategy() {
+    TrajectoryStrategy* strategy = StrategyRegistry::instance().select(currentGameMode, gameSteps);
+    if (strategy == objectA.getStrategy()) {
+        return;
+    }
+    // 工作线程正在使用prefetchObject，先停下来再换策略
+    bool wasPrefetching = stopPrefetch();
+    objectA.setStrategy(strategy);
+    sharedObjectA.setStrategy(strategy);
+    prefetchObject.setStrategy(strategy);
+    if (wasPrefetching) {
+        startPrefetch();
+    }
+}
+
 bool GameManager::CheakIfUserExist(fstream&userInfoFile,string username) {
     if(!userInfoFile.is_open()){
         std::cerr<<"Failed to open userInfoFile"<<std::endl;
@@ -67,17 +119,30 @@ bool GameManager::CheakIfUserExist(fstream&userInfoFile,string username) {
 
 void GameManager::generateGameData() {
     // 生成实际轨迹和相对轨迹
-    if (isMultiplayerMode() && currentPlayerIndex > 0) {
+    if (isThreeDimensionalMode()) {
+        // 三维模式：两条轨迹都在立方体内沿六邻域或二十六邻域移动，起点的分离要求与二维相同
+        object3D.generatePuzzle(topology3, gameSteps, puzzleConstraints.minStartSeparation);
+    } else if (isMultiplayerMode() && currentPlayerIndex > 0) {
         // 在多人模式的第二个玩家时，使用和第一个玩家相同的轨迹数据
         objectA = sharedObjectA;
     } else {
         // 单人模式或多人模式第一个玩家时，生成新的轨迹
-        objectA.generateTrajectory(isComplexMode(), gameSteps);
-        do{objectA.generateRelativeTrajectory(gameSteps, isComplexMode());
-        }while((abs(objectA.getActualTrajectory().getCell(0).getRow()-objectA.getRelativeTrajectory().getCell(0).getRow())<5)&&
-        (abs(objectA.getActualTrajectory().getCell(0).getCol()-objectA.getRelativeTrajectory().getCell(0).getCol())<5));
-        
-        objectA.calculateActualTrajectory();
+        // 已登录时跳过该玩家做过的谜题（平移、旋转、翻转后相同的也算做过）
+        TopologyKind topology = isComplexMode() ? TOPOLOGY_HEX : TOPOLOGY_SQUARE;
+        takeNextPuzzle(topology);
+        if (isLoggedIn) {
+            uint64_t hash = PuzzleHash::hash(topology, objectA.getActualTrajectory().getSpan(),
+                                             objectA.getRelativeTrajectory().getSpan());
+            for (int retry = 0; retry < MAX_SEEN_RETRIES && seenPuzzles.contains(hash); retry++) {
+                takeNextPuzzle(topology);
+                hash = PuzzleHash::hash(topology, objectA.getActualTrajectory().getSpan(),
+                                        objectA.getRelativeTrajectory().getSpan());
+            }
+            // 每局只记在内存中，开启新的一代时写回一次，其余在退出登录或程序结束时写回
+            if (hash != PuzzleHash::INVALID_HASH && seenPuzzles.insert(hash)) {
+                saveSeenPuzzles();
+            }
+        }
         
         // 在多人模式下，保存第一个玩家的轨迹数据供第二个玩家使用
         if (isMultiplayerMode() && currentPlayerIndex == 0) {
@@ -87,24 +152,37 @@ void GameManager::generateGameData() {
 }
 
 
-void GameManager::startNewRound() {
-    // 增加回合数
-    currentRound++;
-    
-    // 在多人模式下，重置玩家索引
-    if (isMultiplayerMode()) {
-        currentPlayerIndex = 0;
+void GameManager::takeNextPuzzle(TopologyKind topology) {
+    if (!takePuzzleFromBank(topology)) {
+        takePrefetchedPuzzle(topology);
     }
-    
-    // 生成新的游戏数据
-    // 这里应该总是生成新数据，因为这是开始新的一轮
-    objectA.generateTrajectory(isComplexMode(), gameSteps);
-    objectA.generateRelativeTrajectory(gameSteps, isComplexMode());
-    objectA.calculateActualTrajectory();
-    
-    // 在多人模式下，保存第一个玩家的轨迹数据供后续玩家使用
-    if (isMultiplayerMode()) {
-        sharedObjectA = objectA;
+}
+
+string GameManager::getSeenPuzzleFile(const string& username) const {
+    // 与用户信息文件放在同一目录
+    string directory;
+    size_t slash = userInfoFile.find_last_of("/\\");
+    if (slash != string::npos) {
+        directory = userInfoFile.substr(0, slash + 1);
+    }
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    string name;
+    for (size_t i = 0; i < username.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(username[i]);
+        if (isalnum(c) || c == '_' || c == '-') {
+            name += static_cast<char>(c);
+        } else {
+            name += '%';
+            name += HEX_DIGITS[c >> 4];
+            name += HEX_DIGITS[c & 15];
+        }
+    }
+    return directory + seenPuzzleFilePrefix + name + ".bin";
+}
+
+void GameManager::saveSeenPuzzles() {
+    if (isLoggedIn) {
+        seenPuzzles.save(getSeenPuzzleFile(loggedInUsername));
     }
 }
 
@@ -174,9 +252,14 @@ bool GameManager::loginUser(fstream&userInfoFile,const std::string& username) {
         return false; // 用户名不存在
     }
     
+    // 换用户登录前先写回上一个用户的记录
+    saveSeenPuzzles();
+
     // 设置当前登录用户
     loggedInUsername = username;
     isLoggedIn = true;
+    // 读取该玩家做过的谜题，没有记录时从空开始
+    seenPuzzles.load(getSeenPuzzleFile(username));
     return true;
 }
 
@@ -195,6 +278,235 @@ const GameObject& GameManager::getObjectA() const {
     return objectA;
 }
 
+void GameManager::setBoard(const BoardConfig& board) {
+    bool wasPrefetching = stopPrefetch();
+    objectA.setBoard(board);
+    sharedObjectA.setBoard(board);
+    prefetchObject.setBoard(board);
+    if (wasPrefetching) {
+        startPrefetch();
+    }
+}
+
+const BoardConfig& GameManager::getBoard() const {
+    return objectA.getBoard();
+}
+
+PuzzleBatch GameManager::generateBatch(size_t count, TopologyKind topology, int steps, uint64_t seed) const {
+    return PuzzleBatch::generate(count, topology, steps, seed, getBoard());
+}
+
+bool GameManager::buildPuzzleBank(const string& path, size_t puzzlesPerSection, uint64_t seed) const {
+    // 每个分区使用由seed派生的不同种子，分区之间的谜题互不相关
+    vector<PuzzleBatch> batches;
+    for (int steps = 1; steps <= SIMPLE_MODE_MAX_STEPS; steps++) {
+        batches.push_back(generateBatch(puzzlesPerSection, TOPOLOGY_SQUARE, steps, PuzzleBatch::puzzleSeed(seed, batches.size())));
+    }
+    for (int steps = 1; steps <= COMPLEX_MODE_MAX_STEPS; steps++) {
+        batches.push_back(generateBatch(puzzlesPerSection, TOPOLOGY_HEX, steps, PuzzleBatch::puzzleSeed(seed, batches.size())));
+    }
+
+    // 按难度档拆分，每个(拓扑, 步数, 难度档)一个分区，没有谜题的分区不写入
+    // 只差平移、旋转或翻转的谜题是同一道题，按规范哈希去重，每道题只保留第一次出现的
+    vector<PuzzleBatch> bands;
+    vector<int> bandOfBatch;
+    for (size_t b = 0; b < batches.size(); b++) {
+        vector<vector<size_t> > members(PuzzleDifficulty::BAND_COUNT);
+        unordered_set<uint64_t> seen;
+        for (size_t i = 0; i < batches[b].size(); i++) {
+            uint64_t hash = PuzzleHash::hash(batches[b].getTopology(), batches[b].getActual(i), batches[b].getRelative(i));
+            if (hash != PuzzleHash::INVALID_HASH && !seen.insert(hash).second) {
+                continue;
+            }
+            PuzzleDifficulty::Features features = PuzzleDifficulty::extract(
+                batches[b].getTopology(), batches[b].getActual(i), batches[b].getRelative(i), batches[b].getFinal(i));
+            members[features.band].push_back(i);
+        }
+        for (int band = 0; band < PuzzleDifficulty::BAND_COUNT; band++) {
+            if (!members[band].empty()) {
+                bands.push_back(batches[b].select(members[band]));
+                bandOfBatch.push_back(band);
+            }
+        }
+    }
+    vector<PuzzleBank::SectionSource> sources;
+    for (size_t i = 0; i < bands.size(); i++) {
+        PuzzleBank::SectionSource source = {&bands[i], bandOfBatch[i]};
+        sources.push_back(source);
+    }
+    return PuzzleBank::write(path, sources, getBoard());
+}
+
+bool GameManager::loadPuzzleBank(const string& path) {
+    return puzzleBank.open(path);
+}
+
+void GameManager::setPuzzleConstraints(const GameObject::PuzzleConstraints& constraints) {
+    // 工作线程生成时会读取约束，先停下来；按旧约束生成的谜题一并丢弃
+    bool wasPrefetching = stopPrefetch();
+    puzzleConstraints = constraints;
+    if (wasPrefetching) {
+        startPrefetch();
+    }
+}
+
+void GameManager::setPuzzleDifficulty(int difficulty) {
+    if (difficulty != ANY_DIFFICULTY && (difficulty < 0 || difficulty >= PuzzleDifficulty::BAND_COUNT)) {
+        throw invalid_argument("GameManager: puzzle difficulty out of range");
+    }
+    // 工作线程按目标难度生成，先停下来；按旧难度生成的谜题一并丢弃
+    bool wasPrefetching = stopPrefetch();
+    puzzleDifficulty = difficulty;
+    if (wasPrefetching) {
+        startPrefetch();
+    }
+}
+
+bool GameManager::takePuzzleFromBank(TopologyKind topology) {
+    // 题库按生成时的棋盘出题，棋盘不同的题目可能越界
+    if (!puzzleBank.isOpen() || puzzleBank.getBoard() != getBoard()) {
+        return false;
+    }
+    // 不限难度时在所有难度档的分区中均匀抽取
+    int firstBand = puzzleDifficulty;
+    int lastBand = puzzleDifficulty;
+    if (puzzleDifficulty == ANY_DIFFICULTY) {
+        firstBand = 0;
+        lastBand = PuzzleDifficulty::BAND_COUNT - 1;
+    }
+    size_t count = 0;
+    for (int band = firstBand; band <= lastBand; band++) {
+        count += puzzleBank.getCount(topology, gameSteps, band);
+    }
+    if (count == 0) {
+        return false;
+    }
+    // 每个分区不超过PuzzleBank::MAX_SECTION_PUZZLES局，几个难度档相加仍在int范围内
+    size_t index = static_cast<size_t>(bankRandom.nextInt(static_cast<int>(count)));
+    int band = firstBand;
+    while (index >= puzzleBank.getCount(topology, gameSteps, band)) {
+        index -= puzzleBank.getCount(topology, gameSteps, band);
+        band++;
+    }
+    PuzzleBank::Puzzle puzzle;
+    if (!puzzleBank.getPuzzle(topology, gameSteps, band, index, puzzle)) {
+        return false;
+    }
+    objectA.loadPuzzle(topology, puzzle.actualTrajectory, puzzle.relativeTrajectory, puzzle.finalTrajectory);
+    return true;
+}
+
+void GameManager::takePrefetchedPuzzle(TopologyKind topology) {
+    // 模式或步数变化前生成的谜题不再适用，丢弃后从同一序号起重新生成，序列仍只取决于种子
+    if (prefetchRunning && (prefetchTopology != topology || prefetchSteps != gameSteps)) {
+        stopPrefetch();
+    }
+    if (!prefetchRunning) {
+        prefetchTopology = topology;
+        prefetchSteps = gameSteps;
+        startPrefetch();
+    }
+
+    // 队列本身无锁，互斥量只用于等待；已经有谜题时直接取出
+    PrefetchedPuzzle puzzle;
+    if (!prefetchQueue.tryPop(puzzle)) {
+        exception_ptr error;
+        {
+            unique_lock<mutex> lock(prefetchMutex);
+            prefetchReady.wait(lock, [this] { return prefetchQueue.size() > 0 || prefetchError; });
+            error = prefetchError;
+        }
+        if (!prefetchQueue.tryPop(puzzle)) {
+            // 工作线程生成这一局时出错并已退出：停下它（下次从这一局重试），把异常交给调用方
+            stopPrefetch();
+            rethrow_exception(error);
+        }
+    }
+    // 通知前短暂持有互斥量：工作线程若已检查过队列已满但还没开始等待，会等到它开始等待后再通知
+    { lock_guard<mutex> lock(prefetchMutex); }
+    prefetchSpace.notify_one();
+    nextPuzzleIndex++;
+    objectA.loadPuzzle(topology, puzzle.actualTrajectory.getSpan(), puzzle.relativeTrajectory.getSpan(),
+                       puzzle.finalTrajectory.getSpan());
+}
+
+void GameManager::startPrefetch() {
+    if (prefetchRunning) {
+        return;
+    }
+    prefetchIndex = nextPuzzleIndex;
+    prefetchRunning = true;
+    prefetchThread = thread(&GameManager::prefetchLoop, this);
+}
+
+bool GameManager::stopPrefetch() {
+    if (!prefetchRunning) {
+        return false;
+    }
+    {
+        lock_guard<mutex> lock(prefetchMutex);
+        prefetchRunning = false;
+    }
+    prefetchSpace.notify_one();
+    if (prefetchThread.joinable()) {
+        prefetchThread.join();
+    }
+    prefetchQueue.clear();
+    prefetchError = nullptr;
+    return true;
+}
+
+void GameManager::prefetchLoop() {
+    // 记录异常后退出，取用到这一局时抛给调用方
+    auto fail = [this](exception_ptr error) {
+        {
+            lock_guard<mutex> lock(prefetchMutex);
+            prefetchError = error;
+        }
+        prefetchReady.notify_one();
+    };
+
+    PrefetchedPuzzle puzzle;
+    while (true) {
+        if (prefetchQueue.full()) {
+            unique_lock<mutex> lock(prefetchMutex);
+            prefetchSpace.wait(lock, [this] { return !prefetchRunning || !prefetchQueue.full(); });
+        }
+        if (!prefetchRunning) {
+            return;
+        }
+        try {
+            prefetchObject.setRandomEngine(RandomEngine(PuzzleBatch::puzzleSeed(prefetchSeed, prefetchIndex)));
+            if (puzzleDifficulty == ANY_DIFFICULTY) {
+                prefetchObject.generatePuzzle(prefetchTopology, prefetchSteps, puzzleConstraints);
+            } else {
+                // 工作线程本身就在后台，按难度抽样时不再另开线程
+                prefetchObject.generatePuzzleInBand(prefetchTopology, prefetchSteps, puzzleDifficulty,
+                                                    puzzleConstraints, 1);
+            }
+            puzzle.actualTrajectory = prefetchObject.getActualTrajectory();
+            puzzle.relativeTrajectory = prefetchObject.getRelativeTrajectory();
+            puzzle.finalTrajectory = prefetchObject.getfinalTrajectory();
+        } catch (...) {
+            fail(current_exception());
+            return;
+        }
+        // 只有本线程放入，生成前已确认有空位，放不进说明队列状态被破坏，按出错处理
+        if (!prefetchQueue.tryPush(puzzle)) {
+            fail(make_exception_ptr(logic_error("GameManager: prefetch queue unexpectedly full")));
+            return;
+        }
+        prefetchIndex++;
+        // 与取出时相同，短暂持有互斥量再通知，避免通知丢失
+        { lock_guard<mutex> lock(prefetchMutex); }
+        prefetchReady.notify_one();
+    }
+}
+
+const GameObject3& GameManager::getObject3D() const {
+    return object3D;
+}
+
 bool GameManager::isGameRunning() const {
     // 返回游戏运行状态
     return gameRunning;
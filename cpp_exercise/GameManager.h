@@ -1,9 +1,21 @@
 #pragma once
 #include "GameObject.h"
+#include "GameObject3.h"
+#include "PuzzleBatch.h"
+#include "PuzzleBank.h"
+#include "PuzzleHash.h"
+#include "SeenPuzzleFilter.h"
+#include "SpscQueue.h"
+#include "TrajectoryStrategy.h"
 #include "Player.h"
 #include <vector>
 #include <string>
 #include <fstream>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 class GameManager {
 public:
@@ -14,11 +26,53 @@ public:
         SIMPLE_MULTI,   // 简单多人模式
         COMPLEX_MULTI,  // 复杂多人模式
         TIME_BASED_MODE, // 计时模式
+        THREE_D_SINGLE,  // 三维单人模式
     };
 
+    // 不限定谜题难度
+    static const int ANY_DIFFICULTY = -1;
+
 private:
+    // 后台预先生成好的一局谜题
+    struct PrefetchedPuzzle {
+        Trajectory actualTrajectory;
+        Trajectory relativeTrajectory;
+        Trajectory finalTrajectory;
+    };
+
+    // 预生成队列的容量
+    static const size_t PREFETCH_CAPACITY = 4;
+
+    // 抽到登录玩家做过的谜题时最多换题的次数，仍然重复时照常出题
+    static const int MAX_SEEN_RETRIES = 8;
+
     GameObject objectA;
     GameObject sharedObjectA; // 用于在多人模式下共享轨迹数据
+    GameObject3 object3D;     // 三维模式的游戏对象
+    Topology3Kind topology3;  // 三维模式的移动拓扑（六邻域或二十六邻域）
+    uint64_t sessionSeed;     // 本次会话的随机种子
+    PuzzleBank puzzleBank;    // 预先生成的谜题库（未找到题库文件时为空）
+    RandomEngine bankRandom;  // 从题库中抽题使用的随机数
+    int puzzleDifficulty;     // 目标难度档（PuzzleDifficulty），ANY_DIFFICULTY表示不限
+    GameObject::PuzzleConstraints puzzleConstraints; // 实时生成谜题时的约束
+    SeenPuzzleFilter seenPuzzles; // 登录玩家做过的谜题，登录时从文件读取
+
+    // 后台预生成：工作线程用自己的prefetchObject按顺序生成谜题放入无锁队列，
+    // 玩家输入预测时就在准备下一回合，开始新回合时按顺序取用，队列为空时等待
+    // 第n局实时生成的谜题只使用由(prefetchSeed, n)派生的随机序列，与工作线程的快慢无关
+    SpscQueue<PrefetchedPuzzle, PREFETCH_CAPACITY> prefetchQueue;
+    GameObject prefetchObject;
+    std::thread prefetchThread;
+    std::atomic<bool> prefetchRunning;
+    TopologyKind prefetchTopology;  // 工作线程生成的拓扑和步数，只在工作线程停止时修改
+    int prefetchSteps;
+    uint64_t prefetchSeed;          // 实时生成谜题的种子
+    size_t nextPuzzleIndex;         // 下一局要取用的谜题序号
+    size_t prefetchIndex;           // 工作线程下一个要生成的序号
+    std::mutex prefetchMutex;       // 只用于两个条件变量的等待和保护prefetchError，队列的放入/取出不加锁
+    std::condition_variable prefetchReady;  // 队列中有了谜题，或工作线程出错退出
+    std::condition_variable prefetchSpace;  // 队列有了空位，或要求工作线程停止
+    std::exception_ptr prefetchError;       // 工作线程生成出错时的异常，取到出错的那一局时抛给调用方
     std::vector<Player> players;
     int currentPlayerIndex;
     GameMode currentGameMode;
@@ -38,11 +92,14 @@ private:
     std::string userInfoFile = "userInfor.txt";
     std::string doubleTempFile = "doubletemp.txt";
     std::string doublePlayerFile = "doubleplayer.txt"; 
+    std::string puzzleBankFile = "puzzlebank.bin";
+    std::string seenPuzzleFilePrefix = "seenpuzzles_"; // 与userInfoFile放在同一目录，后接用户名
     
     // 新增步数限制
     static const int SIMPLE_MODE_MAX_STEPS = 20;
     static const int COMPLEX_MODE_MAX_STEPS = 10;
     static const int TIME_MODE_STEPS = 5;
+    static const int THREE_D_MODE_STEPS = 10;
     
     // 新增计时相关配置
     const int TIMED_MODE_ROUNDS = 2;
@@ -50,9 +107,36 @@ private:
     // 新增方法
     void updateUserStats(const std::string& username, bool isComplexMode, bool isWin);
 
+    // 从题库中随机取一局谜题载入objectA，题库中没有对应的题目时返回false
+    bool takePuzzleFromBank(TopologyKind topology);
+
+    // 按顺序从预生成队列取下一局谜题载入objectA，队列为空时等待工作线程生成
+    // 拓扑或步数与工作线程不同时，丢弃已生成的谜题，从同一序号起按新参数重新生成
+    // 工作线程生成这一局时出错则抛出该异常，下次调用时从这一局重试
+    void takePrefetchedPuzzle(TopologyKind topology);
+
+    // 按当前模式和步数从StrategyRegistry选择生成策略
+    void applyStrategy();
+
+    // 为objectA准备下一局谜题：优先从题库中取，没有时取后台按顺序生成的
+    void takeNextPuzzle(TopologyKind topology);
+
+    // 登录玩家做过的谜题记录文件，用户名中文件名不允许的字符转成十六进制
+    std::string getSeenPuzzleFile(const std::string& username) const;
+
+    // 把登录玩家做过的谜题写回文件，未登录时不做任何事
+    void saveSeenPuzzles();
+
+    // 启动/停止后台工作线程，启动时从nextPuzzleIndex开始生成，停止时清空队列和出错记录；
+    // stopPrefetch返回停止前是否在运行
+    void startPrefetch();
+    bool stopPrefetch();
+    void prefetchLoop();
+
 public:
     // 构造函数
     GameManager();
+    ~GameManager();
     
     // 初始化游戏
     void initializeGame(GameMode mode, std::string username1, std::string username2);
@@ -63,6 +147,56 @@ public:
     // 生成游戏数据（A和B的轨迹等）
     void generateGameData();
 
+    // 设置会话随机种子：二维和三维对象各使用由该种子派生的独立序列，
+    // 同一种子下生成的谜题序列完全相同
+    void setSeed(uint64_t seed);
+    uint64_t getSeed() const {
+        return sessionSeed;
+    }
+
+    // 设置/获取棋盘范围（默认-15到15），锦标赛可使用上万格边长的大棋盘
+    void setBoard(const BoardConfig& board);
+    const BoardConfig& getBoard() const;
+
+    // 在当前棋盘上用全部核心批量生成count个谜题，同一种子的结果完全相同
+    PuzzleBatch generateBatch(size_t count, TopologyKind topology, int steps, uint64_t seed) const;
+
+    // 离线生成题库文件：简单、复杂模式在每个可选步数下各生成puzzlesPerSection局，
+    // 去掉只差平移、旋转或翻转的重复谜题后按难度档分区（步数少时不同的谜题本来就少）
+    bool buildPuzzleBank(const std::string& path, size_t puzzlesPerSection, uint64_t seed) const;
+
+    // 打开题库文件（构造时会自动尝试打开puzzlebank.bin），失败时继续实时生成
+    bool loadPuzzleBank(const std::string& path);
+
+    // 关闭题库，之后实时生成；重新生成同一个题库文件前要先关闭（Windows上被映射的文件不能替换）
+    void closePuzzleBank() {
+        puzzleBank.close();
+    }
+    bool hasPuzzleBank() const {
+        return puzzleBank.isOpen();
+    }
+
+    // 设置/获取实时生成谜题时的约束（起点分离、合成范围、最少转弯次数）
+    void setPuzzleConstraints(const GameObject::PuzzleConstraints& constraints);
+    const GameObject::PuzzleConstraints& getPuzzleConstraints() const {
+        return puzzleConstraints;
+    }
+
+    // 设置/获取三维模式的移动拓扑，下一次生成谜题时生效
+    void setTopology3(Topology3Kind topology) {
+        topology3 = topology;
+    }
+    Topology3Kind getTopology3() const {
+        return topology3;
+    }
+
+    // 设置/获取目标难度档（0到PuzzleDifficulty::BAND_COUNT-1，或ANY_DIFFICULTY）
+    // 题库中从对应难度的分区取题，实时生成时并行抽样直到难度落在该档；越界时抛出invalid_argument
+    void setPuzzleDifficulty(int difficulty);
+    int getPuzzleDifficulty() const {
+        return puzzleDifficulty;
+    }
+
     // 设置轨迹步数
     void setGameSteps(int steps);
     
@@ -102,6 +236,9 @@ public:
     
     // 获取ObjectA
     const GameObject& getObjectA() const;
+
+    // 获取三维模式的游戏对象
+    const GameObject3& getObject3D() const;
     
     
     // 检查游戏是否在运行
@@ -112,6 +249,11 @@ public:
         return currentGameMode == COMPLEX_SINGLE || currentGameMode == COMPLEX_MULTI;
     }
     
+    // 判断是否为三维模式
+    bool isThreeDimensionalMode() const {
+        return currentGameMode == THREE_D_SINGLE;
+    }
+    
     // 判断是否为多人模式
     bool isMultiplayerMode() const {
         return currentGameMode == SIMPLE_MULTI || currentGameMode == COMPLEX_MULTI || currentGameMode == TIME_BASED_MODE;
@@ -130,9 +272,6 @@ public:
     // 检查游戏是否结束
     bool isGameOver() const;
     
-    // 开始新回合
-    void startNewRound();
-    
     // 获取所有玩家
     const std::vector<Player>& getPlayers() const {
         return players;
@@ -155,8 +294,10 @@ public:
     }
     
     void logout() {
+        saveSeenPuzzles();
         isLoggedIn = false;
         loggedInUsername = "";
+        seenPuzzles.clear();
     }
     
     const std::string& getLoggedInUsername() const {
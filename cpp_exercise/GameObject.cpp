@@ -1,59 +1,57 @@
 #include "GameObject.h"
+#include "Directions.h"
+#include "DirectionMask.h"
+#include "SeparatedCellSampler.h"
+#include "TrajectoryStrategy.h"
+#include "PuzzleBatch.h"
 #include <cmath>
-#include <ctime>  // 添加ctime头文件用于time函数
-#include <cstdlib> // 添加cstdlib头文件用于rand函数
 #include <algorithm> // 添加algorithm头文件用于std::min函数
 #include <vector>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 #include<iostream>
 
 using namespace std;
 
-// 坐标范围常量
-const int MIN_TRAJ_COORD = -15;
-const int MAX_TRAJ_COORD = 15;
-
-const vector<GridCell>hex_point={
-    GridCell(0, -2),
-    GridCell(0, 2),
-    GridCell(-1, 1),
-    GridCell(-1, -1),
-    GridCell(1, 1),
-    GridCell(1, -1),
-    GridCell(-1,0),
-    GridCell(1,0)
-};
-const vector<GridCell>four_directions={
-    GridCell(-1, 0),
-    GridCell(0, 1),
-    GridCell(0, -1),
-    GridCell(1, 0)
-    
-};
-const vector<GridCell>hex_directions={
-    GridCell(-2,0),
-    GridCell(-1,-3),
-    GridCell(1, -3),
-    GridCell(2, 0),
-    GridCell(1, 3),
-    GridCell(-1, 3)
-};
-const int UP = 0;
-const int RIGHT = 1;
-const int LEFT = 2;
-const int DOWN = 3;
-const int UP_RIGHT = 5;
-const int DOWN_RIGHT = 4;
-const int DOWN_LEFT = 2;
-const int UP_LEFT = 1;
-
-
-GameObject::GameObject(int startRow, int startCol, const std::string& objectColor) {
+// 棋盘边长不超过该值时，可达性检查用位图记录访问过的格子，否则用哈希集合
+const int DENSE_FLOOD_MAX_SIDE = 64;
+
+// 六方向的轨迹以轴坐标生成，换算到屏幕上列坐标是q + r的3倍；
+// 轴坐标的范围取棋盘的三分之一，换算后占的屏幕范围与四方向相近，两条轨迹通常能同时显示
+const int HEX_BOARD_SCALE = 3;
+
+// 单次回溯最多扩展的结点数，超过后放弃本次尝试，由调用方换一组随机选择重试
+const long MAX_BACKTRACK_NODES = 200000;
+
+using DirectionMask::countBits;
+using DirectionMask::lowestBit;
+
+
+GameObject::GameObject(int startRow, int startCol, const std::string& objectColor)
+    : random(RandomEngine::seedFromClock()), puzzleAttempts(0), puzzleTopology(TOPOLOGY_SQUARE), difficulty(),
+      strategy(StrategyRegistry::instance().find("backtrack")), fallbackStrategy(nullptr) {
+    // 默认棋盘，同时换算出六方向的轴坐标范围
+    setBoard(BoardConfig());
     // 初始化游戏对象，设置起始位置和颜色
     // 将起始位置添加到实际轨迹中
+    // 生成器需要频繁判断格子是否已在轨迹上，为两条生成轨迹启用占用位图
+    actualTrajectory.enableOccupancy();
+    relativeTrajectory.enableOccupancy();
     GridCell initialCell(startRow, startCol);
     actualTrajectory.addCell(initialCell);
 }
 
+void GameObject::seed(uint64_t seedValue) {
+    random.seed(seedValue);
+}
+
+void GameObject::setRandomEngine(const RandomEngine& engine) {
+    random = engine;
+}
+
 const GridCell& GameObject::getCurrentCell(Trajectory&trajectory) const {
     // 返回当前位置
     return trajectory.getCurrentCell();
@@ -61,47 +59,8 @@ const GridCell& GameObject::getCurrentCell(Trajectory&trajectory) const {
     
 
 void GameObject::addCellBasedOnDirection(Trajectory& trajectory,const GridCell& cell, int direction, bool isSixDirection) {
-    GridCell x;
-    
-    if (isSixDirection) {
-        switch (direction) {
-            case UP_RIGHT:
-                x = cell+hex_directions[UP_RIGHT];
-                break;
-            case DOWN_RIGHT:
-                x = cell+hex_directions[DOWN_RIGHT];
-                break;
-            case DOWN:
-                x = cell+hex_directions[DOWN];
-                break;
-            case DOWN_LEFT:
-                x = cell+hex_directions[DOWN_LEFT];
-                break;
-            case UP_LEFT:
-                x = cell+hex_directions[UP_LEFT];
-                break;
-            case UP:
-                x = cell+hex_directions[UP];
-                break;  
-        }
-    } else {
-        switch (direction) {
-            case RIGHT:
-                x = cell+four_directions[RIGHT];
-                break;
-            case UP:
-                x = cell+four_directions[UP];
-                break;
-            case LEFT:
-                x = cell+four_directions[LEFT];
-                break;
-            case DOWN:
-                x = cell+four_directions[DOWN];
-                break;
-        }
-    }
-    
-    trajectory.addCell(x);
+    const GridCell* directions = isSixDirection ? HexTopology::DIRECTIONS : SquareTopology::DIRECTIONS;
+    trajectory.addCell(cell + directions[direction]);
 }
 
 void GameObject::removeFourDirection(Trajectory& trajectory,const GridCell& cell, int direction) {
@@ -113,156 +72,50 @@ void GameObject::removeSixDirection(Trajectory& trajectory,const GridCell& cell,
 }
 
 bool checkIfExist(const Trajectory&trajectory,GridCell newgrid,const int direction,bool ISCOMPLEX){
-    int i=trajectory.getLength();
-    int value=0;
     if(ISCOMPLEX){
-        for(int j=0;j<i;j++){
-        if(trajectory.getCell(j)==(newgrid+hex_directions[direction])) value=1;}
-    }
-    else{
-    for(int j=0;j<i;j++){
-        if(trajectory.getCell(j)==(newgrid+four_directions[direction])) value=1;
-    }
+        return trajectory.contains(newgrid+hex_directions[direction]);
     }
-    return value;
+    return trajectory.contains(newgrid+four_directions[direction]);
 }
 
 void GameObject::generateTrajectory(bool difficulty, int steps) {
-    // 添加随机种子刷新，确保每次调用都获得新的随机序列
-    srand(static_cast<unsigned int>(time(nullptr) * rand()));
-    
-        // 清空现有轨迹
-        actualTrajectory.clear();
-
-        // 生成随机初始坐标（范围-15到15）
-        int startRow = (rand() % (MAX_TRAJ_COORD - MIN_TRAJ_COORD + 1)) + MIN_TRAJ_COORD;
-        int startCol = (rand() % (MAX_TRAJ_COORD - MIN_TRAJ_COORD + 1)) + MIN_TRAJ_COORD;
-        GridCell startCell(startRow, startCol);
-        actualTrajectory.addCell(startCell);
+    generateTrajectory(difficulty ? TOPOLOGY_HEX : TOPOLOGY_SQUARE, steps);
+}
 
-    // 使用回溯算法生成轨迹
-    int maxAttempts = 10;  // 最大尝试次数
-    bool success = false;
-    
-    for (int attempt = 0; attempt < maxAttempts && !success; attempt++) {
-        // 每次尝试使用新的随机种子
-        srand(static_cast<unsigned int>(time(nullptr) * rand() + attempt));
-        success = generateTrajectoryBacktrack(actualTrajectory, 0, steps, -1, difficulty);
-        
-        if (!success && attempt < maxAttempts - 1) {
-            // 如果失败且还有尝试机会，清空轨迹并重新添加起始点
-            actualTrajectory.clear();
-            actualTrajectory.addCell(startCell);
-        }
-    }
-    
-    // 如果多次尝试后仍然失败，生成一个简单的线性轨迹
-    /*if (!success) {
-        cout << "使用备用轨迹生成方法" << endl;
-        actualTrajectory.clear();
-        actualTrajectory.addCell(startCell);
-        
-        // 简单的直线轨迹生成
-        for (int i = 0; i < steps; i++) {
-            const GridCell& currentCell = actualTrajectory.getCurrentCell();
-            int row = currentCell.getRow();
-            int col = currentCell.getCol();
-            
-            // 交替水平和垂直移动
-            if (i % 2 == 0) {
-                // 确保在边界内
-                if (row + 1 <= MAX_TRAJ_COORD) {
-                    GridCell newCell(row + 1, col);
-                    actualTrajectory.addCell(newCell);
-                } else {
-                    GridCell newCell(row - 1, col);
-                    actualTrajectory.addCell(newCell);
-                }
-            } else {
-                // 确保在边界内
-                if (col + 1 <= MAX_TRAJ_COORD) {
-                    GridCell newCell(row, col + 1);
-                    actualTrajectory.addCell(newCell);
-                } else {
-                    GridCell newCell(row, col - 1);
-                    actualTrajectory.addCell(newCell);
-                }
-        }
-    }
-    }*/
+void GameObject::generateTrajectory(TopologyKind topology, int steps) {
+    puzzleTopology = topology;
+    generateWalk(actualTrajectory, randomBoardCell(), steps, topology, 0, CellSpan());
 }
 
 void GameObject::generateRelativeTrajectory(int steps, bool difficulty) {
-    // 添加随机种子刷新，确保每次调用都获得新的随机序列
-    srand(static_cast<unsigned int>(time(nullptr) * rand() + 12345));
-    
-    // 清空现有相对轨迹
-    relativeTrajectory.clear();
-    
-    // 生成随机初始坐标（范围-15到15）
-    int startRow = (rand() % (MAX_TRAJ_COORD - MIN_TRAJ_COORD + 1)) + MIN_TRAJ_COORD;
-    int startCol = (rand() % (MAX_TRAJ_COORD - MIN_TRAJ_COORD + 1)) + MIN_TRAJ_COORD;
-    GridCell startCell(startRow, startCol);
-    relativeTrajectory.addCell(startCell);
-    
-    // 使用回溯算法生成轨迹
-    int maxAttempts = 10;  // 最大尝试次数
-    bool success = false;
-    
-    for (int attempt = 0; attempt < maxAttempts && !success; attempt++) {
-        // 每次尝试使用新的随机种子
-        srand(static_cast<unsigned int>(time(nullptr) * rand() + 54321 + attempt));
-        success = generateTrajectoryBacktrack(relativeTrajectory, 0, steps, -1, difficulty);
-        
-        if (!success && attempt < maxAttempts - 1) {
-            // 如果失败且还有尝试机会，清空轨迹并重新添加起始点
-            relativeTrajectory.clear();
-            relativeTrajectory.addCell(startCell);
-            }
-    }
+    generateRelativeTrajectory(steps, difficulty ? TOPOLOGY_HEX : TOPOLOGY_SQUARE);
+}
+
+void GameObject::generateRelativeTrajectory(int steps, TopologyKind topology) {
+    puzzleTopology = topology;
+    generateWalk(relativeTrajectory, randomBoardCell(), steps, topology, 0, CellSpan());
+}
     
-    // 如果多次尝试后仍然失败，生成一个简单的线性轨迹
-    /*if (!success) {
-        cout << "使用备用轨迹生成方法" << endl;
-        relativeTrajectory.clear();
-        relativeTrajectory.addCell(startCell);
-        
-        // 简单的直线轨迹生成
-        for (int i = 0; i < steps; i++) {
-            const GridCell& currentCell = relativeTrajectory.getCurrentCell();
-            int row = currentCell.getRow();
-            int col = currentCell.getCol();
-            
-            // 交替水平和垂直移动，与generateTrajectory相反方向
-            if (i % 2 == 1) {
-                // 确保在边界内
-                if (row + 1 <= MAX_TRAJ_COORD) {
-                    GridCell newCell(row + 1, col);
-                    relativeTrajectory.addCell(newCell);
-                } else {
-                    GridCell newCell(row - 1, col);
-                    relativeTrajectory.addCell(newCell);
-                }
-            } else {
-                // 确保在边界内
-                if (col + 1 <= MAX_TRAJ_COORD) {
-                    GridCell newCell(row, col + 1);
-                    relativeTrajectory.addCell(newCell);
-                } else {
-                    GridCell newCell(row, col - 1);
-                    relativeTrajectory.addCell(newCell);
-                }
-        }
+
+int GameObject::pickCompositeStart(int offsetMin, int offsetMax) {
+    // 起点坐标x要满足 min <= x + offsetMin 且 x + offsetMax <= max
+    const BoardConfig& walkBoard = getBoard(puzzleTopology);
+    int low = walkBoard.getMinCoord() - offsetMin;
+    int high = walkBoard.getMaxCoord() - offsetMax;
+    if (low <= high) {
+        return random.nextInRange(low, high);
     }
+    // 合成轨迹比棋盘还宽（没有要求finalInBounds时可能出现），退而放进界面显示的两倍棋盘范围
+    low = 2 * walkBoard.getMinCoord() - offsetMin;
+    high = 2 * walkBoard.getMaxCoord() - offsetMax;
+    if (low <= high) {
+        return random.nextInRange(low, high);
     }
-    */
+    // 仍然放不下时让轨迹居中
+    return (walkBoard.getMinCoord() + walkBoard.getMaxCoord()) / 2 - (offsetMin + offsetMax) / 2;
 }
-    
 
 void GameObject::calculateActualTrajectory() {
-    // 添加随机种子刷新，确保每次调用都获得新的随机起点
-    srand(static_cast<unsigned int>(time(nullptr) * rand() + 67890));
-    
     // 清空现有实际轨迹
     finalTrajectory.clear();
     
@@ -272,27 +125,200 @@ void GameObject::calculateActualTrajectory() {
     
     // 确保至少有起始点
     if (actLength < 1 || relLength < 1) {
+        difficulty = PuzzleDifficulty::extract(puzzleTopology, actualTrajectory.getSpan(), relativeTrajectory.getSpan(), CellSpan());
         return;
     }
     
-    // 随机生成实际轨迹的起始点（范围-15到15）
-double startRow = (rand()% (MAX_TRAJ_COORD - MIN_TRAJ_COORD + 1)) + MIN_TRAJ_COORD;
-double startCol = (rand()% (MAX_TRAJ_COORD - MIN_TRAJ_COORD + 1)) + MIN_TRAJ_COORD;
-finalTrajectory.addCell(GridCell(startRow, startCol));
-    
-    // 使用四方向移动生成实际轨迹，确保每次只移动1个单位
-    int lastDirection = -1;
     int minLength = min(actLength, relLength);
-    for(int i=1;i<minLength;i++){
-        GridCell newCell = finalTrajectory.getCurrentCell()+
-                         actualTrajectory.getCell(i)-actualTrajectory.getCell(i-1)+
-                         relativeTrajectory.getCell(i)-relativeTrajectory.getCell(i-1);
-        
-        
-        finalTrajectory.addCell(newCell);
+    CellSpan actual = actualTrajectory.getSpan();
+    CellSpan relative = relativeTrajectory.getSpan();
+
+    // 第i个单元格相对起点的偏移是前i步位移之和，等于两条轨迹各自相对起点的偏移相加
+    // 先求出所有偏移的包围盒，再在能让整条轨迹留在棋盘内的起点中均匀选取，一次完成，不需要重试
+    GridCell actualStart = actual[0];
+    GridCell relativeStart = relative[0];
+    int minRow = 0, maxRow = 0, minCol = 0, maxCol = 0;
+    for (int i = 1; i < minLength; i++) {
+        GridCell offset = actual[i] - actualStart + relative[i] - relativeStart;
+        minRow = min(minRow, offset.getRow());
+        maxRow = max(maxRow, offset.getRow());
+        minCol = min(minCol, offset.getCol());
+        maxCol = max(maxCol, offset.getCol());
+    }
+    GridCell startCell(pickCompositeStart(minRow, maxRow), pickCompositeStart(minCol, maxCol));
+
+    for (int i = 0; i < minLength; i++) {
+        finalTrajectory.addCell(startCell + (actual[i] - actualStart) + (relative[i] - relativeStart));
+    }
+    difficulty = PuzzleDifficulty::extract(puzzleTopology, actual, relative, finalTrajectory.getSpan());
+}
+
+
+bool GameObject::generatePuzzle(TopologyKind topology, int steps, const PuzzleConstraints& constraints) {
+    puzzleAttempts = 0;
+    puzzleTopology = topology;
+
+    GridCell actualStart = randomBoardCell();
+    bool satisfied = generateWalk(actualTrajectory, actualStart, steps, topology,
+                                             constraints.minTurns, CellSpan());
+
+    // 相对轨迹的起点只在与参考轨迹起点相距足够远的格子中抽取，不再反复重新生成整条轨迹
+    const BoardConfig& walkBoard = getBoard(topology);
+    int row, col;
+    if (!SeparatedCellSampler::pick(random, walkBoard.getMinCoord(), walkBoard.getMaxCoord(), actualStart.getRow(),
+                                    actualStart.getCol(), constraints.minStartSeparation, row, col)) {
+        // 棋盘太小，没有满足分离要求的格子
+        satisfied = false;
+        row = random.nextInRange(walkBoard.getMinCoord(), walkBoard.getMaxCoord());
+        col = random.nextInRange(walkBoard.getMinCoord(), walkBoard.getMaxCoord());
+    }
+    // 合成范围的约束以完整的参考轨迹为准，参考轨迹没有生成完整时无法约束
+    CellSpan companion;
+    if (constraints.finalInBounds && actualTrajectory.getLength() == static_cast<size_t>(steps) + 1) {
+        companion = actualTrajectory.getSpan();
+    }
+    satisfied = generateWalk(relativeTrajectory, GridCell(row, col), steps, topology,
+                                        constraints.minTurns, companion) && satisfied;
+
+    calculateActualTrajectory();
+    return satisfied;
+}
+
+int GameObject::getPuzzleAttempts() const {
+    return puzzleAttempts;
+}
+
+bool GameObject::generatePuzzleInBand(TopologyKind topology, int steps, int band,
+                                      const PuzzleConstraints& constraints, unsigned threads) {
+    if (band < 0 || band >= PuzzleDifficulty::BAND_COUNT) {
+        throw invalid_argument("GameObject: difficulty band out of range");
+    }
+    // 第k个候选只使用由(baseSeed, k)派生的随机序列
+    uint64_t baseSeed = random.next();
+    if (threads == 0) {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+
+    // 各线程依次领取候选编号，编号不小于已找到的最小编号时停止；
+    // 比最终结果小的编号一定都被检查过，所以结果总是编号最小的符合者
+    atomic<size_t> nextCandidate(0);
+    atomic<size_t> found(MAX_BAND_CANDIDATES);
+    mutex resultMutex;
+    Trajectory bestActual, bestRelative, bestFinal;
+    exception_ptr error;
+
+    auto work = [&]() {
+        try {
+            GameObject worker(*this);
+            for (;;) {
+                size_t k = nextCandidate.fetch_add(1, memory_order_relaxed);
+                if (k >= found.load(memory_order_relaxed)) {
+                    break;
+                }
+                worker.setRandomEngine(RandomEngine(PuzzleBatch::puzzleSeed(baseSeed, k)));
+                worker.generatePuzzle(topology, steps, constraints);
+                if (worker.difficulty.band != band) {
+                    continue;
+                }
+                lock_guard<mutex> lock(resultMutex);
+                if (k < found.load(memory_order_relaxed)) {
+                    found = k;
+                    bestActual = worker.actualTrajectory;
+                    bestRelative = worker.relativeTrajectory;
+                    bestFinal = worker.finalTrajectory;
+                }
+            }
+        } catch (...) {
+            lock_guard<mutex> lock(resultMutex);
+            if (!error) {
+                error = current_exception();
+            }
+            found = 0;
+        }
+    };
+
+    vector<thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; t++) {
+        pool.emplace_back(work);
     }
+    work();
+    for (size_t t = 0; t < pool.size(); t++) {
+        pool[t].join();
+    }
+
+    if (error) {
+        rethrow_exception(error);
+    }
+    if (found == MAX_BAND_CANDIDATES) {
+        generatePuzzle(topology, steps, constraints);
+        return false;
+    }
+    loadPuzzle(topology, bestActual.getSpan(), bestRelative.getSpan(), bestFinal.getSpan());
+    return true;
+}
+
+const PuzzleDifficulty::Features& GameObject::getDifficulty() const {
+    return difficulty;
+}
+
+bool GameObject::generateWalk(Trajectory& trajectory, const GridCell& start, int steps, TopologyKind topology,
+                              int minTurns, CellSpan companion) {
+    bool constrained = minTurns > 0 || !companion.empty();
+    if (constrained) {
+        walkConstraint.minTurns = minTurns;
+        walkConstraint.companion = companion;
+        walkConstraint.origin = start;
+    }
+
+    // 每次尝试都从同一个起点重新开始
+    bool success = false;
+    for (int attempt = 0; attempt < MAX_WALK_ATTEMPTS && !success; attempt++) {
+        trajectory.clear();
+        trajectory.addCell(start);
+        puzzleAttempts++;
+        // 只有回溯支持附加约束，有约束时总是回溯生成
+        if (constrained) {
+            success = visitTopology(topology, [&](auto t) {
+                return backtrack<decltype(t)>(trajectory, 0, steps, -1, true);
+            });
+        } else {
+            success = strategy->generate(*this, trajectory, steps, topology);
+        }
+    }
+
+    // 多次尝试后仍然失败时使用备用策略（没有设置时保留最后一次的结果）
+    if (!success && fallbackStrategy != nullptr) {
+        trajectory.clear();
+        trajectory.addCell(start);
+        success = fallbackStrategy->generate(*this, trajectory, steps, topology);
+    }
+    return success;
+}
+
+GridCell GameObject::randomBoardCell() {
+    const BoardConfig& walkBoard = getBoard(puzzleTopology);
+    int row = random.nextInRange(walkBoard.getMinCoord(), walkBoard.getMaxCoord());
+    int col = random.nextInRange(walkBoard.getMinCoord(), walkBoard.getMaxCoord());
+    return GridCell(row, col);
 }
 
+void GameObject::loadPuzzle(TopologyKind topology, CellSpan actualCells, CellSpan relativeCells, CellSpan finalCells) {
+    puzzleTopology = topology;
+    actualTrajectory.clear();
+    relativeTrajectory.clear();
+    finalTrajectory.clear();
+    for (const GridCell& cell : actualCells) {
+        actualTrajectory.addCell(cell);
+    }
+    for (const GridCell& cell : relativeCells) {
+        relativeTrajectory.addCell(cell);
+    }
+    for (const GridCell& cell : finalCells) {
+        finalTrajectory.addCell(cell);
+    }
+    difficulty = PuzzleDifficulty::extract(topology, actualCells, relativeCells, finalCells);
+}
 
 const Trajectory& GameObject::getfinalTrajectory() const {
     // 返回玩家预测的轨迹
@@ -309,99 +335,290 @@ const Trajectory& GameObject::getActualTrajectory() const {
     return actualTrajectory;
 }
 
+template <typename Topology>
+bool GameObject::exceedsBounds(const GridCell& cell, int direction) const {
+    return !getBoard(Topology::KIND).contains(cell + Topology::DIRECTIONS[direction]);
+}
+
 bool GameObject::wouldExceedBounds(const GridCell& cell, int direction, bool isSixDirection) {
-    GridCell newCell = cell;
-    if (isSixDirection) {
-        switch (direction) {
-            case 0: newCell = cell + hex_directions[0]; break;
-            case 1: newCell = cell + hex_directions[1]; break;
-            case 2: newCell = cell + hex_directions[2]; break;
-            case 3: newCell = cell + hex_directions[3]; break;
-            case 4: newCell = cell + hex_directions[4]; break;
-            case 5: newCell = cell + hex_directions[5]; break;
+    return isSixDirection ? exceedsBounds<HexTopology>(cell, direction)
+                          : exceedsBounds<SquareTopology>(cell, direction);
+}
+
+bool GameObject::generateTrajectoryPerm(Trajectory& trajectory, int steps, TopologyKind topology) {
+    return sampler.sample(random, trajectory, steps, topology, getBoard(topology));
+}
+
+void GameObject::setGenerationMethod(GenerationMethod method) {
+    setStrategy(StrategyRegistry::instance().find(method == GENERATE_PERM ? "perm" : "backtrack"));
+}
+
+void GameObject::setStrategy(TrajectoryStrategy* generationStrategy) {
+    if (generationStrategy != nullptr) {
+        strategy = generationStrategy;
+    }
+}
+
+TrajectoryStrategy* GameObject::getStrategy() const {
+    return strategy;
+}
+
+void GameObject::setFallbackStrategy(TrajectoryStrategy* generationStrategy) {
+    fallbackStrategy = generationStrategy;
+}
+
+RandomEngine& GameObject::getRandomEngine() {
+    return random;
+}
+
+void GameObject::setBoard(const BoardConfig& config) {
+    board = config;
+    hexBoard = BoardConfig(config.getMinCoord() / HEX_BOARD_SCALE, config.getMaxCoord() / HEX_BOARD_SCALE);
+}
+
+const BoardConfig& GameObject::getBoard() const {
+    return board;
+}
+
+const BoardConfig& GameObject::getBoard(TopologyKind topology) const {
+    return topology == TOPOLOGY_HEX ? hexBoard : board;
+}
+
+GameObject::GenerationMethod GameObject::getGenerationMethod() const {
+    return strategy == StrategyRegistry::instance().find("perm") ? GENERATE_PERM : GENERATE_BACKTRACK;
+}
+
+const PermSampler::Stats& GameObject::getSamplerStats() const {
+    return sampler.getStats();
+}
+
+bool GameObject::generateTrajectoryBacktrack(Trajectory& trajectory, int depth, int maxDepth, int lastDir, bool isComplex) {
+    return generateTrajectoryBacktrack(trajectory, depth, maxDepth, lastDir, isComplex ? TOPOLOGY_HEX : TOPOLOGY_SQUARE);
+}
+
+bool GameObject::generateTrajectoryBacktrack(Trajectory& trajectory, int depth, int maxDepth, int lastDir, TopologyKind topology) {
+    // 只在入口处根据拓扑分派一次
+    return visitTopology(topology, [&](auto t) {
+        return backtrack<decltype(t)>(trajectory, depth, maxDepth, lastDir);
+    });
+}
+
+template <typename Topology>
+uint32_t GameObject::legalMoves(const Trajectory& trajectory, const GridCell& cell, int lastDir) const {
+    // 逐个方向计算“在边界内且未被占用”，合成一个位掩码，循环体内没有分支
+    uint32_t mask = 0;
+    for (int dir = 0; dir < Topology::DIRECTION_COUNT; dir++) {
+        GridCell newCell = cell + Topology::DIRECTIONS[dir];
+        mask |= static_cast<uint32_t>(getBoard(Topology::KIND).contains(newCell) & !trajectory.contains(newCell)) << dir;
+    }
+    // 不允许沿原路返回
+    if (lastDir >= 0) {
+        mask &= ~(uint32_t(1) << Topology::OPPOSITE[lastDir]);
+    }
+    return mask;
+}
+
+int GameObject::pickDirection(uint32_t mask) {
+    // 在置位的方向中均匀选取一个
+    return DirectionMask::pickBit(random, mask);
+}
+
+template <typename Topology>
+bool GameObject::hasRoomFor(const Trajectory& trajectory, const GridCell& from, int needed) {
+    // from是一个空闲格子（下一步的落点），从它出发做泛洪填充，统计所在空闲区域的大小，
+    // 够needed个就提前返回。可达区域只会多估不会少估，所以据此剪枝不会丢掉可行解
+    // 小棋盘用位图记录访问过的格子；大棋盘改用哈希集合，内存只与访问过的格子数有关
+    const BoardConfig& walkBoard = getBoard(Topology::KIND);
+    const int side = walkBoard.getSide();
+    const bool dense = side <= DENSE_FLOOD_MAX_SIDE;
+    auto firstVisit = [&](const GridCell& cell) {
+        if (!dense) {
+            return floodSeen.insert(cell) == 1;
+        }
+        unsigned index = static_cast<unsigned>(cell.getRow() - walkBoard.getMinCoord()) * side +
+                         static_cast<unsigned>(cell.getCol() - walkBoard.getMinCoord());
+        uint64_t bit = uint64_t(1) << (index & 63);
+        if (floodVisited[index >> 6] & bit) {
+            return false;
         }
+        floodVisited[index >> 6] |= bit;
+        return true;
+    };
+    if (dense) {
+        floodVisited.assign((side * side + 63) / 64, 0);
     } else {
-        switch (direction) {
-            case 0: newCell = cell + four_directions[0]; break;
-            case 1: newCell = cell + four_directions[1]; break;
-            case 2: newCell = cell + four_directions[2]; break;
-            case 3: newCell = cell + four_directions[3]; break;
+        floodSeen.clear();
+    }
+
+    floodQueue.clear();
+    floodQueue.push_back(from);
+    firstVisit(from);
+    int reached = 1;
+    if (reached >= needed) {
+        return true;
+    }
+    for (size_t head = 0; head < floodQueue.size(); head++) {
+        GridCell cell = floodQueue[head];
+        for (int dir = 0; dir < Topology::DIRECTION_COUNT; dir++) {
+            GridCell next = cell + Topology::DIRECTIONS[dir];
+            if (!walkBoard.contains(next)) continue;
+            if (!firstVisit(next)) continue;
+            if (trajectory.contains(next)) continue;
+            if (++reached >= needed) {
+                return true;
+            }
+            floodQueue.push_back(next);
         }
     }
-    
-    return (newCell.getRow() < MIN_TRAJ_COORD || newCell.getRow() > MAX_TRAJ_COORD ||
-            newCell.getCol() < MIN_TRAJ_COORD || newCell.getCol() > MAX_TRAJ_COORD);
+    return false;
 }
 
-bool GameObject::generateTrajectoryBacktrack(Trajectory& trajectory, int depth, int maxDepth, int lastDir, bool isComplex) {
-    // 达到目标深度，轨迹生成完成
-    if (depth >= maxDepth) {
-        return true;
+template <typename Topology>
+uint32_t GameObject::pruneMoves(const Trajectory& trajectory, const GridCell& cell, uint32_t mask, int remaining) {
+    // 剩余步数不止一步时，去掉落点所在空闲区域不足remaining格的方向：
+    // 走进这样的死角注定失败，不必再穷举它
+    if (remaining <= 1) {
+        return mask;
     }
-    
-    // 获取当前单元格
-    const GridCell& currentCell = trajectory.getCurrentCell();
-    
-    // 创建方向序列并随机打乱
-    vector<int> directions;
-    int numDirs = isComplex ? 6 : 4;
-    for (int i = 0; i < numDirs; i++) {
-        directions.push_back(i);
+    uint32_t pending = mask;
+    while (pending != 0) {
+        int dir = lowestBit(pending);
+        pending &= pending - 1;
+        if (!hasRoomFor<Topology>(trajectory, cell + Topology::DIRECTIONS[dir], remaining)) {
+            mask &= ~(uint32_t(1) << dir);
+        }
     }
-    
-    // 简单随机化方向顺序
-    for (int i = 0; i < numDirs; i++) {
-        int j = rand() % numDirs;
-        swap(directions[i], directions[j]);
+    return mask;
+}
+
+template <typename Topology>
+bool GameObject::splitsFreeRegion(const Trajectory& trajectory, const GridCell& cell) const {
+    // 绕cell一圈，统计被占用/出界的格子构成几段连续的弧
+    // 只有一段（或没有）时，其余空闲格子沿这一圈彼此相连，占用cell不会把空闲区域分开
+    const BoardConfig& walkBoard = getBoard(Topology::KIND);
+    int arcs = 0;
+    GridCell last = cell + Topology::RING[Topology::RING_SIZE - 1];
+    bool previousBlocked = !walkBoard.contains(last) || trajectory.contains(last);
+    for (int i = 0; i < Topology::RING_SIZE; i++) {
+        GridCell next = cell + Topology::RING[i];
+        bool blocked = !walkBoard.contains(next) || trajectory.contains(next);
+        arcs += blocked & !previousBlocked;
+        previousBlocked = blocked;
     }
-    
-    // 尝试每个方向
-    for (int dir : directions) {
-        // 如果这是相反方向，跳过（避免来回走）
-        if (lastDir != -1) {
-            if (isComplex && abs(dir - lastDir) == 3) continue;
-            if (!isComplex && ((dir == 0 && lastDir == 3) ||
-                               (dir == 3 && lastDir == 0) ||
-                               (dir == 1 && lastDir == 2) ||
-                               (dir == 2 && lastDir == 1))) continue;
+    return arcs > 1;
+}
+
+template <typename Topology>
+uint32_t GameObject::constrainMoves(const GridCell& cell, int level, uint32_t mask, int remaining) const {
+    const WalkState& state = walkConstraint.states[level];
+
+    // 转弯次数：第一步不算转弯；剩下的每一步都转弯也不够时，这一步不能再直行
+    if (walkConstraint.minTurns > 0) {
+        int reachable = state.turns + (state.lastDir < 0 ? remaining - 1 : remaining);
+        if (reachable < walkConstraint.minTurns) {
+            return 0;
         }
-        
-        // 如果新位置超出边界，跳过
-        if (wouldExceedBounds(currentCell, dir, isComplex)) continue;
-        
-        // 如果新位置已经在轨迹中，跳过（避免环路）
-        GridCell newCell;
-        if (isComplex) {
-            newCell = currentCell + hex_directions[dir];
-        } else {
-            newCell = currentCell + four_directions[dir];
+        if (state.lastDir >= 0 && reachable - 1 < walkConstraint.minTurns) {
+            mask &= ~(uint32_t(1) << state.lastDir);
+        }
+    }
+
+    // 合成范围：落点对应的合成位置不能让包围盒超过棋盘边长
+    const CellSpan& companion = walkConstraint.companion;
+    if (!companion.empty() && static_cast<size_t>(level) + 1 < companion.size()) {
+        const int limit = getBoard(Topology::KIND).getSide() - 1;
+        GridCell shift = companion[level + 1] - companion[0] - walkConstraint.origin;
+        uint32_t pending = mask;
+        while (pending != 0) {
+            int dir = lowestBit(pending);
+            pending &= pending - 1;
+            GridCell composite = cell + Topology::DIRECTIONS[dir] + shift;
+            if (max(state.maxRow, composite.getRow()) - min(state.minRow, composite.getRow()) > limit ||
+                max(state.maxCol, composite.getCol()) - min(state.minCol, composite.getCol()) > limit) {
+                mask &= ~(uint32_t(1) << dir);
+            }
         }
-        bool cellExists = false;
-        for (size_t i = 0; i < trajectory.getLength(); i++) {
-            if (trajectory.getCell(i) == newCell) {
-                cellExists = true;
-                break;
+    }
+    return mask;
+}
+
+void GameObject::advanceWalkState(const GridCell& cell, int level, int dir) {
+    const WalkState& previous = walkConstraint.states[level - 1];
+    WalkState& state = walkConstraint.states[level];
+    state = previous;
+    state.lastDir = dir;
+    state.turns += previous.lastDir >= 0 && previous.lastDir != dir;
+    const CellSpan& companion = walkConstraint.companion;
+    if (!companion.empty() && static_cast<size_t>(level) < companion.size()) {
+        GridCell composite = cell - walkConstraint.origin + companion[level] - companion[0];
+        state.minRow = min(state.minRow, composite.getRow());
+        state.maxRow = max(state.maxRow, composite.getRow());
+        state.minCol = min(state.minCol, composite.getCol());
+        state.maxCol = max(state.maxCol, composite.getCol());
+    }
+}
+
+template <typename Topology>
+bool GameObject::backtrack(Trajectory& trajectory, int depth, int maxDepth, int lastDir, bool constrained) {
+    // 迭代回溯：moveStack[i]记录第i层还没有尝试过的合法方向
+    // 每层只占一个掩码，栈在多次生成之间复用，生成几千步也不会有递归深度问题
+    int steps = maxDepth - depth;
+    if (steps <= 0) {
+        return true;
+    }
+    if (moveStack.size() < static_cast<size_t>(steps)) {
+        moveStack.resize(steps);
+    }
+
+    int level = 0;
+    long expanded = 0;
+    uint32_t firstMoves = legalMoves<Topology>(trajectory, trajectory.getCurrentCell(), lastDir);
+    if (constrained) {
+        WalkState origin = {lastDir, 0, 0, 0, 0, 0};
+        walkConstraint.states.resize(steps + 1);
+        walkConstraint.states[0] = origin;
+        firstMoves = constrainMoves<Topology>(trajectory.getCurrentCell(), 0, firstMoves, steps);
+    }
+    moveStack[0] = pruneMoves<Topology>(trajectory, trajectory.getCurrentCell(), firstMoves, steps);
+    while (true) {
+        uint32_t& untried = moveStack[level];
+        if (untried == 0) {
+            // 这一层的方向都失败了：回到上一层
+            if (level == 0) {
+                return false;
             }
+            trajectory.pop_back();
+            level--;
+            continue;
         }
-        if (cellExists) continue;
-        
-        // 添加新单元格
-        if (isComplex) {
-            removeSixDirection(trajectory, currentCell, dir);
-        } else {
-            removeFourDirection(trajectory, currentCell, dir);
+
+        // 剪枝后仍可能在困难的长轨迹上耗时过久，超出预算时撤销本次尝试
+        if (++expanded > MAX_BACKTRACK_NODES) {
+            for (; level > 0; level--) {
+                trajectory.pop_back();
+            }
+            return false;
         }
-        
-        // 递归生成下一步
-        if (generateTrajectoryBacktrack(trajectory, depth + 1, maxDepth, dir, isComplex)) {
+
+        int dir = pickDirection(untried);
+        untried &= ~(uint32_t(1) << dir);
+        GridCell newCell = trajectory.getCurrentCell() + Topology::DIRECTIONS[dir];
+        trajectory.addCell(newCell);
+        level++;
+
+        // 达到目标深度，轨迹生成完成
+        if (level == steps) {
             return true;
         }
-        
-        // 回溯：移除最后添加的单元格
-        trajectory.getCells().pop_back();
+        // 落点不会分割空闲区域时，各方向所在的区域就是上一层检查过的区域去掉落点，
+        // 一定还容得下剩余步数，不必重新泛洪
+        moveStack[level] = legalMoves<Topology>(trajectory, newCell, dir);
+        if (constrained) {
+            advanceWalkState(newCell, level, dir);
+            moveStack[level] = constrainMoves<Topology>(newCell, level, moveStack[level], steps - level);
+        }
+        if (splitsFreeRegion<Topology>(trajectory, newCell)) {
+            moveStack[level] = pruneMoves<Topology>(trajectory, newCell, moveStack[level], steps - level);
+        }
     }
-    
-    // 所有方向都尝试过但没有解决方案
-    return false;
 }
-
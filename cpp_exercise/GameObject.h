@@ -1,21 +1,81 @@
 #pragma once
 #include "GridCell.h"
 #include "Trajectory.h"
+#include "Topology.h"
+#include "RandomEngine.h"
+#include "PermSampler.h"
+#include "BoardConfig.h"
+#include "CellHashSet.h"
+#include "PuzzleDifficulty.h"
 #include <string>
 #include <vector>
 
+class TrajectoryStrategy;
+
 class GameObject {
+public:
+    // 轨迹生成方法
+    enum GenerationMethod {
+        GENERATE_BACKTRACK, // 随机回溯（默认）
+        GENERATE_PERM       // PERM采样，长轨迹下接近均匀分布
+    };
+
+    // 联合生成参考轨迹和相对轨迹时的约束，生成时直接满足，而不是生成后检查再重来
+    struct PuzzleConstraints {
+        int minStartSeparation; // 两条轨迹的起点至少在行或列上相距这么多格（0表示不限制）
+        bool finalInBounds;     // 合成后的实际轨迹的范围不超过棋盘，这样合成时总能整条放进棋盘
+        int minTurns;           // 参考轨迹和相对轨迹各自至少转弯的次数
+
+        PuzzleConstraints(int separation = 5, bool inBounds = false, int turns = 0)
+            : minStartSeparation(separation), finalInBounds(inBounds), minTurns(turns) {}
+    };
+
 protected:
     Trajectory actualTrajectory; // 对象的实际移动轨迹 
     Trajectory relativeTrajectory;  // 相对轨迹
     Trajectory predictedTrajectory;  // 玩家预测的轨迹
     Trajectory finalTrajectory;
+    RandomEngine random;             // 生成轨迹使用的随机数引擎
+    std::vector<uint32_t> moveStack; // 迭代回溯的显式栈，每层一个未尝试方向的掩码
+    std::vector<uint64_t> floodVisited; // 可达性检查的访问位图（小棋盘）
+    CellHashSet floodSeen;              // 可达性检查访问过的格子（大棋盘）
+    std::vector<GridCell> floodQueue;   // 可达性检查的队列
+    BoardConfig board;                  // 生成轨迹的棋盘范围
+    BoardConfig hexBoard;               // 复杂模式生成轨迹的轴坐标范围，由board换算
+    PermSampler sampler;
+
+    // 回溯时附加的约束，states[i]是走完i步之后的状态；回溯只会回到更浅的层，
+    // 那一层的状态仍然有效，所以按层覆盖即可，不需要撤销
+    struct WalkState {
+        int lastDir;        // 最后一步的方向（-1表示还没有移动）
+        int turns;          // 已经转弯的次数
+        int minRow, maxRow; // 合成轨迹（相对于起点）的包围盒
+        int minCol, maxCol;
+    };
+    struct WalkConstraint {
+        int minTurns;
+        CellSpan companion;  // 非空时与之合成的轨迹（参考轨迹），合成后的包围盒不能超过棋盘
+        GridCell origin;     // 正在生成的轨迹的起点
+        std::vector<WalkState> states;
+    };
+    WalkConstraint walkConstraint;
+    int puzzleAttempts;                 // 最近一次generatePuzzle调用回溯/采样的次数
+    TopologyKind puzzleTopology;        // 当前谜题的移动拓扑，生成或载入谜题时更新，难度特征按它判断相邻
+    PuzzleDifficulty::Features difficulty; // 当前谜题的难度特征，合成或载入谜题时更新
+    TrajectoryStrategy* strategy;          // 生成轨迹的策略（由StrategyRegistry持有）
+    TrajectoryStrategy* fallbackStrategy;  // 多次尝试仍失败时使用的备用策略，可以为空
 
 public:
     // 构造函数
     GameObject(int startRow = 0, int startCol = 0, const std::string& objectColor = "white");
     
     
+    // 设置随机种子，相同的种子生成相同的轨迹
+    void seed(uint64_t seedValue);
+
+    // 替换随机数引擎（例如使用由同一种子派生的独立序列）
+    void setRandomEngine(const RandomEngine& engine);
+    
     // 获取当前位置
     const GridCell& getCurrentCell(Trajectory&trajectory) const;
     //设置四个方向的移动
@@ -23,17 +83,67 @@ public:
     //设置六个方向的移动
     void removeSixDirection(Trajectory& trajectory,const GridCell&cell,int direction);
     
-    // 生成实际轨迹
+    // 生成实际轨迹（difficulty为true时使用六方向，否则四方向）
     void generateTrajectory(bool difficulty, int steps);
+    void generateTrajectory(TopologyKind topology, int steps);
     
     // 生成相对轨迹
     void generateRelativeTrajectory(int steps, bool difficulty);
+    void generateRelativeTrajectory(int steps, TopologyKind topology);
     
     // 回溯法辅助函数
     bool generateTrajectoryBacktrack(Trajectory& trajectory, int depth, int maxDepth, int lastDir, bool isComplex);
+    bool generateTrajectoryBacktrack(Trajectory& trajectory, int depth, int maxDepth, int lastDir, TopologyKind topology);
+    
+    // PERM采样生成，trajectory中已有起点
+    bool generateTrajectoryPerm(Trajectory& trajectory, int steps, TopologyKind topology);
+
+    // 设置/获取棋盘范围，生成器、越界检查和界面都以此为准
+    void setBoard(const BoardConfig& config);
+    const BoardConfig& getBoard() const;
+
+    // 该拓扑下生成轨迹实际使用的范围：六方向是轴坐标q、r的范围，其余与getBoard()相同
+    const BoardConfig& getBoard(TopologyKind topology) const;
+
+    // 选择生成方法（相当于选择backtrack或perm策略）
+    void setGenerationMethod(GenerationMethod method);
+    GenerationMethod getGenerationMethod() const;
+
+    // 设置/获取生成策略（见StrategyRegistry），传入空指针时保持不变
+    void setStrategy(TrajectoryStrategy* generationStrategy);
+    TrajectoryStrategy* getStrategy() const;
+
+    // 设置备用策略，例如zigzag；为空时生成失败就保留最后一次的结果
+    void setFallbackStrategy(TrajectoryStrategy* generationStrategy);
+
+    // 生成使用的随机数引擎，供策略使用
+    RandomEngine& getRandomEngine();
+
+    // 最近一次PERM采样的统计（权重、有效样本数、每秒样本数）
+    const PermSampler::Stats& getSamplerStats() const;
     
     // 根据参考轨迹和相对轨迹计算实际轨迹
     void calculateActualTrajectory();
+
+    // 联合生成一局完整的谜题：参考轨迹、满足约束的相对轨迹，以及合成后的实际轨迹
+    // 相对轨迹的起点直接在满足分离要求的格子中均匀抽取，转弯次数和合成范围在回溯中直接约束
+    // 所有约束都满足时返回true；无法满足时保留最后一次的结果并返回false
+    bool generatePuzzle(TopologyKind topology, int steps, const PuzzleConstraints& constraints = PuzzleConstraints());
+
+    // 最近一次generatePuzzle调用回溯/采样的次数（两条轨迹合计，每条至少一次）
+    int getPuzzleAttempts() const;
+
+    // 生成难度落在第band档（见PuzzleDifficulty）的谜题：多个线程并行生成候选，取编号最小的符合者，
+    // 候选的种子由本对象的随机数派生，结果与线程数无关；threads为0时使用全部硬件线程
+    // MAX_BAND_CANDIDATES个候选都不符合时按普通方式生成一局并返回false；band越界时抛出invalid_argument
+    bool generatePuzzleInBand(TopologyKind topology, int steps, int band,
+                              const PuzzleConstraints& constraints = PuzzleConstraints(), unsigned threads = 0);
+
+    // 当前谜题的难度特征
+    const PuzzleDifficulty::Features& getDifficulty() const;
+
+    // 直接载入一局现成的谜题（例如来自谜题库），不做生成
+    void loadPuzzle(TopologyKind topology, CellSpan actualCells, CellSpan relativeCells, CellSpan finalCells);
     
     
     // 获取实际轨迹
@@ -50,4 +160,57 @@ public:
     
     // 辅助函数：检查移动是否会超出边界
     bool wouldExceedBounds(const GridCell& cell, int direction, bool isSixDirection);
-}; 
\ No newline at end of file
+
+private:
+    // 生成一条轨迹的最大尝试次数
+    static const int MAX_WALK_ATTEMPTS = 10;
+
+    // 按难度生成时最多尝试的候选谜题数
+    static const size_t MAX_BAND_CANDIDATES = 4096;
+
+    // 从start出发生成steps步：没有约束时交给当前策略，有约束时用带walkConstraint的回溯
+    // 最多尝试MAX_WALK_ATTEMPTS次，之后使用备用策略；累加puzzleAttempts
+    bool generateWalk(Trajectory& trajectory, const GridCell& start, int steps, TopologyKind topology,
+                      int minTurns, CellSpan companion);
+
+    // 棋盘内均匀随机的格子
+    GridCell randomBoardCell();
+
+    // 按拓扑实例化的回溯生成（迭代实现），constrained为true时遵守walkConstraint
+    template <typename Topology>
+    bool backtrack(Trajectory& trajectory, int depth, int maxDepth, int lastDir, bool constrained = false);
+
+    // 按walkConstraint去掉第level层不满足约束的方向，remaining为包括这一步在内的剩余步数
+    template <typename Topology>
+    uint32_t constrainMoves(const GridCell& cell, int level, uint32_t mask, int remaining) const;
+
+    // 记录第level步（方向dir，落在cell）之后的约束状态
+    void advanceWalkState(const GridCell& cell, int level, int dir);
+
+    // 合成轨迹某一坐标轴上的起点：偏移范围为[offsetMin, offsetMax]，在能让整条轨迹留在棋盘内的位置中均匀选取
+    int pickCompositeStart(int offsetMin, int offsetMax);
+
+    // 从cell出发的合法方向掩码：在边界内、未被占用、不是lastDir的反方向
+    template <typename Topology>
+    uint32_t legalMoves(const Trajectory& trajectory, const GridCell& cell, int lastDir) const;
+
+    // 空闲格子from所在的空闲区域是否至少有needed格（泛洪填充，提前结束）
+    template <typename Topology>
+    bool hasRoomFor(const Trajectory& trajectory, const GridCell& from, int needed);
+
+    // 占用cell是否可能把周围的空闲区域分成几块（绕cell一圈的阻挡格子不止一段）
+    template <typename Topology>
+    bool splitsFreeRegion(const Trajectory& trajectory, const GridCell& cell) const;
+
+    // 去掉落点所在空闲区域容纳不下剩余步数的方向
+    template <typename Topology>
+    uint32_t pruneMoves(const Trajectory& trajectory, const GridCell& cell, uint32_t mask, int remaining);
+
+    // 在掩码的置位方向中均匀随机选取一个
+    int pickDirection(uint32_t mask);
+
+    // 按拓扑实例化的越界检查
+    template <typename Topology>
+    bool exceedsBounds(const GridCell& cell, int direction) const;
+};
+ 
\ No newline at end of file
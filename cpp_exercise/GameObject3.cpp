@@ -0,0 +1,142 @@
+#include "GameObject3.h"
+#include "SeparatedCellSampler.h"
+#include <algorithm>
+using namespace std;
+
+GameObject3::GameObject3() : random(RandomEngine::seedFromClock()) {
+    // 与GameObject一致，实际轨迹从原点开始
+    actualTrajectory.addCell(GridCell3(0, 0, 0));
+}
+
+void GameObject3::seed(uint64_t seedValue) {
+    random.seed(seedValue);
+}
+
+void GameObject3::setRandomEngine(const RandomEngine& engine) {
+    random = engine;
+}
+
+GridCell3 GameObject3::randomCell() {
+    int row = random.nextInRange(MIN_COORD, MAX_COORD);
+    int col = random.nextInRange(MIN_COORD, MAX_COORD);
+    int layer = random.nextInRange(MIN_COORD, MAX_COORD);
+    return GridCell3(row, col, layer);
+}
+
+bool GameObject3::outOfBounds(const GridCell3& cell) {
+    return cell.getRow() < MIN_COORD || cell.getRow() > MAX_COORD ||
+           cell.getCol() < MIN_COORD || cell.getCol() > MAX_COORD ||
+           cell.getLayer() < MIN_COORD || cell.getLayer() > MAX_COORD;
+}
+
+void GameObject3::generateInto(Trajectory3& trajectory, const GridCell3& startCell, Topology3Kind topology, int steps) {
+    trajectory.clear();
+    trajectory.addCell(startCell);
+
+    // 与二维相同：最多尝试10次
+    int maxAttempts = 10;
+    bool success = false;
+    for (int attempt = 0; attempt < maxAttempts && !success; attempt++) {
+        success = generateTrajectoryBacktrack(trajectory, 0, steps, -1, topology);
+        if (!success && attempt < maxAttempts - 1) {
+            trajectory.clear();
+            trajectory.addCell(startCell);
+        }
+    }
+}
+
+void GameObject3::generateTrajectory(Topology3Kind topology, int steps) {
+    generateInto(actualTrajectory, randomCell(), topology, steps);
+}
+
+void GameObject3::generateRelativeTrajectory(int steps, Topology3Kind topology) {
+    generateInto(relativeTrajectory, randomCell(), topology, steps);
+}
+
+void GameObject3::generatePuzzle(Topology3Kind topology, int steps, int minStartSeparation) {
+    generateTrajectory(topology, steps);
+    GridCell3 actualStart = actualTrajectory[0];
+    int row, col, layer;
+    GridCell3 relativeStart;
+    if (SeparatedCellSampler::pick(random, MIN_COORD, MAX_COORD, actualStart.getRow(), actualStart.getCol(),
+                                   actualStart.getLayer(), minStartSeparation, row, col, layer)) {
+        relativeStart = GridCell3(row, col, layer);
+    } else {
+        relativeStart = randomCell();
+    }
+    generateInto(relativeTrajectory, relativeStart, topology, steps);
+    calculateActualTrajectory();
+}
+
+bool GameObject3::generateTrajectoryBacktrack(Trajectory3& trajectory, int depth, int maxDepth, int lastDir, Topology3Kind topology) {
+    return visitTopology3(topology, [&](auto t) {
+        return backtrack<decltype(t)>(trajectory, depth, maxDepth, lastDir);
+    });
+}
+
+template <typename Topology>
+bool GameObject3::backtrack(Trajectory3& trajectory, int depth, int maxDepth, int lastDir) {
+    if (depth >= maxDepth) {
+        return true;
+    }
+
+    GridCell3 currentCell = trajectory.getCurrentCell();
+
+    // 随机打乱方向顺序（Fisher-Yates）
+    int directions[Topology::DIRECTION_COUNT];
+    for (int i = 0; i < Topology::DIRECTION_COUNT; i++) {
+        directions[i] = i;
+    }
+    for (int i = Topology::DIRECTION_COUNT - 1; i > 0; i--) {
+        int j = random.nextInt(i + 1);
+        swap(directions[i], directions[j]);
+    }
+
+    for (int dir : directions) {
+        // 跳过相反方向
+        if (lastDir != -1 && dir == Topology::OPPOSITE[lastDir]) continue;
+
+        GridCell3 newCell = currentCell + Topology::DIRECTIONS[dir];
+        if (outOfBounds(newCell)) continue;
+        if (trajectory.contains(newCell)) continue;
+
+        trajectory.addCell(newCell);
+        if (backtrack<Topology>(trajectory, depth + 1, maxDepth, dir)) {
+            return true;
+        }
+        trajectory.pop_back();
+    }
+    return false;
+}
+
+void GameObject3::calculateActualTrajectory() {
+    finalTrajectory.clear();
+
+    size_t actLength = actualTrajectory.getLength();
+    size_t relLength = relativeTrajectory.getLength();
+    if (actLength < 1 || relLength < 1) {
+        return;
+    }
+
+    // 随机起点，之后每一步叠加实际轨迹与相对轨迹的位移
+    finalTrajectory.addCell(randomCell());
+    size_t minLength = min(actLength, relLength);
+    for (size_t i = 1; i < minLength; i++) {
+        GridCell3 newCell = finalTrajectory.getCurrentCell() +
+                            actualTrajectory[i] - actualTrajectory[i - 1] +
+                            relativeTrajectory[i] - relativeTrajectory[i - 1];
+        finalTrajectory.addCell(newCell);
+    }
+}
+
+const Trajectory3& GameObject3::getActualTrajectory() const {
+    return actualTrajectory;
+}
+
+const Trajectory3& GameObject3::getRelativeTrajectory() const {
+    return relativeTrajectory;
+}
+
+const Trajectory3& GameObject3::getfinalTrajectory() const {
+    return finalTrajectory;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "GridCell3.h"
+#include "Trajectory3.h"
+#include "Topology3.h"
+#include "RandomEngine.h"
+
+// 三维模式的游戏对象：在立方体网格中按六邻域或二十六邻域移动
+// 生成与合成规则与GameObject相同
+class GameObject3 {
+protected:
+    Trajectory3 actualTrajectory;    // 对象的实际移动轨迹
+    Trajectory3 relativeTrajectory;  // 相对轨迹
+    Trajectory3 finalTrajectory;     // 合成后的最终轨迹
+    RandomEngine random;             // 生成轨迹使用的随机数引擎
+
+public:
+    // 生成轨迹的立方体范围
+    static const int MIN_COORD = Trajectory3::OCCUPANCY_MIN_COORD;
+    static const int MAX_COORD = Trajectory3::OCCUPANCY_MAX_COORD;
+
+    // 构造函数
+    GameObject3();
+
+    // 设置随机种子/替换随机数引擎，与GameObject相同
+    void seed(uint64_t seedValue);
+    void setRandomEngine(const RandomEngine& engine);
+
+    // 生成实际轨迹
+    void generateTrajectory(Topology3Kind topology, int steps);
+
+    // 生成相对轨迹
+    void generateRelativeTrajectory(int steps, Topology3Kind topology);
+
+    // 回溯法生成，成功返回true
+    bool generateTrajectoryBacktrack(Trajectory3& trajectory, int depth, int maxDepth, int lastDir, Topology3Kind topology);
+
+    // 根据实际轨迹和相对轨迹计算最终轨迹
+    void calculateActualTrajectory();
+
+    // 生成一局完整的谜题，相对轨迹的起点直接在与参考轨迹起点相距足够远的格子中抽取
+    void generatePuzzle(Topology3Kind topology, int steps, int minStartSeparation);
+
+    // 获取各条轨迹
+    const Trajectory3& getActualTrajectory() const;
+    const Trajectory3& getRelativeTrajectory() const;
+    const Trajectory3& getfinalTrajectory() const;
+
+private:
+    // 从startCell出发回溯生成steps步
+    void generateInto(Trajectory3& trajectory, const GridCell3& startCell, Topology3Kind topology, int steps);
+
+    template <typename Topology>
+    bool backtrack(Trajectory3& trajectory, int depth, int maxDepth, int lastDir);
+
+    static bool outOfBounds(const GridCell3& cell);
+    GridCell3 randomCell();
+};
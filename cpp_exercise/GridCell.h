@@ -1,23 +1,78 @@
 #pragma once
+#include <cstdint>
+#include <cstddef>
+#include <functional>
 
+// 网格单元：行、列各占16位，打包进一个32位整数
+// 高16位为行，低16位为列（均为补码），便于整体比较、哈希和排序
 class GridCell {
 private:
-    int row;
-    int col;//double因为每个位置图像可能是一个正六边形
+    uint32_t packed;
+
+    static constexpr uint32_t ROW_MASK = 0xFFFF0000u;
+    static constexpr uint32_t COL_MASK = 0x0000FFFFu;
+    // 翻转两个通道的符号位后，无符号比较即等价于按(行,列)的有符号字典序比较
+    static constexpr uint32_t SIGN_FLIP = 0x80008000u;
+
+    static constexpr uint32_t pack(int r, int c) {
+        return (static_cast<uint32_t>(static_cast<uint16_t>(r)) << 16) |
+               static_cast<uint32_t>(static_cast<uint16_t>(c));
+    }
+
+    struct RawTag {};
+    constexpr GridCell(uint32_t bits, RawTag) : packed(bits) {}
 
 public:
     // 构造函数
-    GridCell(int r = 0, int c = 0);
+    constexpr GridCell(int r = 0, int c = 0) : packed(pack(r, c)) {}
+
+    // 由打包值直接构造
+    static constexpr GridCell fromPacked(uint32_t bits) { return GridCell(bits, RawTag()); }
 
-    
     // 获取行列坐标
-    int getRow() const;
-    int getCol() const;
-    
+    constexpr int getRow() const { return static_cast<int16_t>(static_cast<uint16_t>(packed >> 16)); }
+    constexpr int getCol() const { return static_cast<int16_t>(static_cast<uint16_t>(packed & COL_MASK)); }
+
+    // 获取打包后的原始值
+    constexpr uint32_t getPacked() const { return packed; }
+
+    // 获取排序键：按行优先、列其次的顺序单调递增
+    constexpr uint32_t getSortKey() const { return packed ^ SIGN_FLIP; }
+
     // 比较两个网格单元是否相等
-    bool operator==(const GridCell& other) const;
-    bool operator!=(const GridCell& other) const;
+    constexpr bool operator==(const GridCell& other) const { return packed == other.packed; }
+    constexpr bool operator!=(const GridCell& other) const { return packed != other.packed; }
+
+    // 按(行,列)字典序比较
+    constexpr bool operator<(const GridCell& other) const { return getSortKey() < other.getSortKey(); }
+    constexpr bool operator>(const GridCell& other) const { return other < *this; }
+    constexpr bool operator<=(const GridCell& other) const { return !(other < *this); }
+    constexpr bool operator>=(const GridCell& other) const { return !(*this < other); }
+
+    // 两个通道分别相加/相减，列通道的进位不会溢出到行通道
+    constexpr GridCell operator+(const GridCell& other) const {
+        return GridCell(((packed & ROW_MASK) + (other.packed & ROW_MASK)) |
+                        ((packed + other.packed) & COL_MASK), RawTag());
+    }
+    constexpr GridCell operator-(const GridCell& other) const {
+        return GridCell(((packed & ROW_MASK) - (other.packed & ROW_MASK)) |
+                        ((packed - other.packed) & COL_MASK), RawTag());
+    }
+
+    GridCell& operator+=(const GridCell& other) { return *this = *this + other; }
+    GridCell& operator-=(const GridCell& other) { return *this = *this - other; }
+};
+
+static_assert(sizeof(GridCell) == 4, "GridCell应打包为32位");
 
-    GridCell operator+(const GridCell& other)const;
-    GridCell operator-(const GridCell& other)const;
-}; 
\ No newline at end of file
+namespace std {
+    template <>
+    struct hash<GridCell> {
+        size_t operator()(const GridCell& cell) const noexcept {
+            // 乘法散列，把相邻坐标打散到不同的桶
+            uint64_t x = cell.getPacked();
+            x *= 0x9E3779B97F4A7C15ull;
+            return static_cast<size_t>(x ^ (x >> 32));
+        }
+    };
+}
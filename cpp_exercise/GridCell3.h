@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+// 三维网格单元：行、列、层各占16位，打包进一个64位整数（低48位）
+// 位于[32,48)的是行，[16,32)是列，[0,16)是层
+class GridCell3 {
+private:
+    uint64_t packed;
+
+    static constexpr uint64_t ROW_MASK = 0xFFFF00000000ull;
+    static constexpr uint64_t COL_MASK = 0x0000FFFF0000ull;
+    static constexpr uint64_t LAYER_MASK = 0x00000000FFFFull;
+
+    static constexpr uint64_t pack(int r, int c, int l) {
+        return (static_cast<uint64_t>(static_cast<uint16_t>(r)) << 32) |
+               (static_cast<uint64_t>(static_cast<uint16_t>(c)) << 16) |
+               static_cast<uint64_t>(static_cast<uint16_t>(l));
+    }
+
+    struct RawTag {};
+    constexpr GridCell3(uint64_t bits, RawTag) : packed(bits) {}
+
+public:
+    // 构造函数
+    constexpr GridCell3(int r = 0, int c = 0, int l = 0) : packed(pack(r, c, l)) {}
+
+    // 获取坐标
+    constexpr int getRow() const { return static_cast<int16_t>(static_cast<uint16_t>(packed >> 32)); }
+    constexpr int getCol() const { return static_cast<int16_t>(static_cast<uint16_t>(packed >> 16)); }
+    constexpr int getLayer() const { return static_cast<int16_t>(static_cast<uint16_t>(packed)); }
+
+    // 获取打包后的原始值
+    constexpr uint64_t getPacked() const { return packed; }
+
+    constexpr bool operator==(const GridCell3& other) const { return packed == other.packed; }
+    constexpr bool operator!=(const GridCell3& other) const { return packed != other.packed; }
+
+    // 三个通道分别相加/相减，进位不跨通道
+    constexpr GridCell3 operator+(const GridCell3& other) const {
+        return GridCell3((((packed & ROW_MASK) + (other.packed & ROW_MASK)) & ROW_MASK) |
+                         (((packed & COL_MASK) + (other.packed & COL_MASK)) & COL_MASK) |
+                         ((packed + other.packed) & LAYER_MASK), RawTag());
+    }
+    constexpr GridCell3 operator-(const GridCell3& other) const {
+        return GridCell3((((packed & ROW_MASK) - (other.packed & ROW_MASK)) & ROW_MASK) |
+                         (((packed & COL_MASK) - (other.packed & COL_MASK)) & COL_MASK) |
+                         ((packed - other.packed) & LAYER_MASK), RawTag());
+    }
+};
+
+namespace std {
+    template <>
+    struct hash<GridCell3> {
+        size_t operator()(const GridCell3& cell) const noexcept {
+            uint64_t x = cell.getPacked() * 0x9E3779B97F4A7C15ull;
+            return static_cast<size_t>(x ^ (x >> 29));
+        }
+    };
+}
@@ -0,0 +1,51 @@
+#include "HexCell.h"
+#include <cmath>
+using namespace std;
+
+bool HexCell::fromOffset(const GridCell& offset, HexCell& result) {
+    // 行 = q - r，列 = 3 * (q + r)
+    int row = offset.getRow();
+    int col = offset.getCol();
+    if (col % 3 != 0) {
+        return false;
+    }
+    int sum = col / 3;     // q + r
+    if ((row + sum) % 2 != 0) {
+        return false;
+    }
+    result = HexCell((sum + row) / 2, (sum - row) / 2);
+    return true;
+}
+
+vector<HexCell> HexCell::lineTo(const HexCell& other) const {
+    // 在立方坐标中线性插值，再取整到最近的单元格
+    int steps = distanceTo(other);
+    vector<HexCell> line;
+    line.reserve(steps + 1);
+    if (steps == 0) {
+        line.push_back(*this);
+        return line;
+    }
+
+    // 轻微偏移，避免插值点正好落在两格交界处时取整不稳定
+    const double nudgeQ = 1e-6, nudgeR = 2e-6;
+    double q0 = q + nudgeQ, r0 = r + nudgeR;
+    double q1 = other.q + nudgeQ, r1 = other.r + nudgeR;
+    for (int i = 0; i <= steps; i++) {
+        double t = static_cast<double>(i) / steps;
+        double fq = q0 + (q1 - q0) * t;
+        double fr = r0 + (r1 - r0) * t;
+        double fs = -fq - fr;
+
+        double rq = round(fq), rr = round(fr), rs = round(fs);
+        double dq = fabs(rq - fq), dr = fabs(rr - fr), ds = fabs(rs - fs);
+        // 误差最大的分量由另外两个分量推出，保证q+r+s=0
+        if (dq > dr && dq > ds) {
+            rq = -rr - rs;
+        } else if (dr > ds) {
+            rr = -rq - rs;
+        }
+        line.push_back(HexCell(static_cast<int>(rq), static_cast<int>(rr)));
+    }
+    return line;
+}
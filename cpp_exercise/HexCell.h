@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "GridCell.h"
+
+// 六边形网格的轴坐标(q, r)，第三个立方坐标s = -q - r
+// 复杂模式的轨迹以轴坐标存放在GridCell中（行通道为q，列通道为r），每一步都是单位步；
+// 只有绘制和读取玩家输入时才换算成屏幕上的行列偏移：
+//   行 = q - r，列 = 3 * (q + r)
+class HexCell {
+private:
+    int16_t q;
+    int16_t r;
+
+    static constexpr int absolute(int x) { return x < 0 ? -x : x; }
+    static constexpr int maximum(int a, int b) { return a > b ? a : b; }
+
+public:
+    // 六个方向的数量
+    static const int DIRECTION_COUNT = 6;
+
+    // 构造函数
+    constexpr HexCell(int q = 0, int r = 0) : q(static_cast<int16_t>(q)), r(static_cast<int16_t>(r)) {}
+
+    // 获取轴坐标
+    constexpr int getQ() const { return q; }
+    constexpr int getR() const { return r; }
+    constexpr int getS() const { return -q - r; }
+
+    constexpr bool operator==(const HexCell& other) const { return q == other.q && r == other.r; }
+    constexpr bool operator!=(const HexCell& other) const { return !(*this == other); }
+    constexpr bool operator<(const HexCell& other) const {
+        return q < other.q || (q == other.q && r < other.r);
+    }
+
+    constexpr HexCell operator+(const HexCell& other) const { return HexCell(q + other.q, r + other.r); }
+    constexpr HexCell operator-(const HexCell& other) const { return HexCell(q - other.q, r - other.r); }
+
+    // 与存放在GridCell中的轴坐标互相转换
+    static constexpr HexCell fromCell(const GridCell& cell) { return HexCell(cell.getRow(), cell.getCol()); }
+    constexpr GridCell toCell() const { return GridCell(q, r); }
+
+    // 方向单位向量，下标顺序与hex_directions一致（上、左上、左下、下、右下、右上），相反方向相差3
+    static constexpr HexCell direction(int index) {
+        return index == 0 ? HexCell(-1, 1) :
+               index == 1 ? HexCell(-1, 0) :
+               index == 2 ? HexCell(0, -1) :
+               index == 3 ? HexCell(1, -1) :
+               index == 4 ? HexCell(1, 0) :
+                            HexCell(0, 1);
+    }
+
+    // 相反方向
+    static constexpr int opposite(int index) { return (index + 3) % DIRECTION_COUNT; }
+
+    // 相邻单元格
+    constexpr HexCell neighbor(int index) const { return *this + direction(index); }
+
+    // 到另一单元格的最少步数
+    constexpr int distanceTo(const HexCell& other) const {
+        return maximum(absolute(q - other.q), maximum(absolute(r - other.r), absolute(getS() - other.getS())));
+    }
+
+    // 换算成屏幕行列偏移（仅绘制时使用）
+    constexpr GridCell toOffset() const { return GridCell(q - r, 3 * (q + r)); }
+
+    // 由屏幕行列偏移换算（读取玩家输入时使用），偏移不在六边形网格上时返回false
+    static bool fromOffset(const GridCell& offset, HexCell& result);
+
+    // 两点之间的直线经过的单元格（含两端），长度为distanceTo+1
+    std::vector<HexCell> lineTo(const HexCell& other) const;
+};
+
+static_assert(sizeof(HexCell) == 4, "HexCell应为32位");
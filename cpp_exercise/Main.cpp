@@ -1,4 +1,6 @@
 #include "GameManager.h"
+#include "Directions.h"
+#include "HexCell.h"
 #include <iostream>
 #include <vector>
 #include <string>
@@ -10,6 +12,7 @@
 #include <map>
 #include <algorithm>
 #include <limits>
+#include <cstdlib>
 #if defined(_WIN32)
 #include <windows.h>
 #endif
@@ -22,6 +25,7 @@ Trajectory inputPrediction(const GameObject &objectA, int steps, bool isComplexM
 void savePlayerScore(const string &username, const string &mode, int score);
 void runSinglePlayerGame(GameManager &gameManager);
 void BeginGame(GameManager &gameManager, string username);
+void chooseDifficulty(GameManager &gameManager);
 void showPlayerStats(const string &username);
 void showGameRankings();
 
@@ -72,8 +76,8 @@ void customQuickSort(std::vector<T> &arr, Compare comp)
     }
 }
 
-// 用于控制台可视化的网格大小
-const int GRID_SIZE = 61;
+// 控制台可视化网格的最大边长
+const int MAX_VIEW_SIZE = 61;
 const char EMPTY_CELL = '.';
 const char ACTUAL_PATH = 'A';
 const char RELATIVE_PATH = 'R';
@@ -82,61 +86,95 @@ const char OVERLAP_AR = 'C';  // 实际和相对轨迹重叠
 const char OVERLAP_AP = 'M';  // 实际和预测轨迹重叠
 const char OVERLAP_RP = 'O';  // 相对和预测轨迹重叠
 const char OVERLAP_ALL = '*'; // 所有轨迹重叠
-const int MIN_GRID_COORD = -30;
-const int MAX_GRID_COORD = 30;
-const int MIN_TRAJ_COORD = -15;
-const int MAX_TRAJ_COORD = 15;
-
-const vector<GridCell> hex_point = {
-    GridCell(0, -2),
-    GridCell(0, 2),
-    GridCell(-1, 1),
-    GridCell(-1, -1),
-    GridCell(1, 1),
-    GridCell(1, -1),
-    GridCell(-1, 0),
-    GridCell(1, 0)};
-const vector<GridCell> four_directions = {
-    GridCell(-1, 0),
-    GridCell(0, 1),
-    GridCell(0, -1),
-    GridCell(1, 0)
-
-};
-const vector<GridCell> hex_directions = {
-    GridCell(-2, 0),
-    GridCell(-1, -3),
-    GridCell(1, -3),
-    GridCell(2, 0),
-    GridCell(1, 3),
-    GridCell(-1, 3)};
-const int UP = 0;
-const int RIGHT = 1;
-const int LEFT = 2;
-const int DOWN = 3;
-const int UP_RIGHT = 5;
-const int DOWN_RIGHT = 4;
-const int DOWN_LEFT = 2;
-const int UP_LEFT = 1;
 
 const string userInfoFile = "userInfor.txt";
 const string doublePlayerResultFile = "doublePlayerResult.txt";
 
+// 复杂模式的轨迹以六边形轴坐标存放，显示和输入时换算成屏幕行列偏移
+GridCell toScreen(const GridCell &cell, bool isComplexMode)
+{
+    return isComplexMode ? HexCell::fromCell(cell).toOffset() : cell;
+}
+
+// 可输入/显示的屏幕坐标范围：合成后的轨迹最远可达生成范围的两倍；
+// 复杂模式下生成范围限制的是轴坐标，取两倍范围四个角换算后的包围盒
+void getInputRange(const BoardConfig &board, bool isComplexMode, int &minRow, int &maxRow, int &minCol, int &maxCol)
+{
+    const int corners[2] = {2 * board.getMinCoord(), 2 * board.getMaxCoord()};
+    GridCell origin = toScreen(GridCell(corners[0], corners[0]), isComplexMode);
+    minRow = maxRow = origin.getRow();
+    minCol = maxCol = origin.getCol();
+    for (int a : corners)
+    {
+        for (int b : corners)
+        {
+            GridCell corner = toScreen(GridCell(a, b), isComplexMode);
+            minRow = min(minRow, corner.getRow());
+            maxRow = max(maxRow, corner.getRow());
+            minCol = min(minCol, corner.getCol());
+            maxCol = max(maxCol, corner.getCol());
+        }
+    }
+}
+
 // 用于显示轨迹的函数
 void displayTrajectories(const GameObject &objectA, const Trajectory &predictedPath, bool isComplexMode, bool showFinalTrajectory)
 {
-    // 创建一个空的网格
-    vector<vector<string>> grid(GRID_SIZE, vector<string>(GRID_SIZE, "."));
-
     // 获取轨迹
     const Trajectory &actualTrajectory = objectA.getActualTrajectory();
     const Trajectory &relativeTrajectory = objectA.getRelativeTrajectory();
     const Trajectory &finalTrajectory = objectA.getfinalTrajectory();
 
-    // 确定网格范围 -30到30
-    const int MIN_COORD = MIN_GRID_COORD;
-    const int MAX_COORD = MAX_GRID_COORD;
-    const int OFFSET = MAX_COORD; // 用于将坐标转换为索引的偏移量
+    // 确定网格范围：默认棋盘显示-30到30的整个范围；
+    // 某个方向超过MAX_VIEW_SIZE时（棋盘更大，或复杂模式换算后列的范围更宽），
+    // 该方向只显示以轨迹包围盒中心为中心的MAX_VIEW_SIZE大小的窗口
+    const BoardConfig &board = objectA.getBoard(isComplexMode ? TOPOLOGY_HEX : TOPOLOGY_SQUARE);
+    int viewMinRow, viewMaxRow, viewMinCol, viewMaxCol;
+    getInputRange(board, isComplexMode, viewMinRow, viewMaxRow, viewMinCol, viewMaxCol);
+    int rowCount = viewMaxRow - viewMinRow + 1;
+    int colCount = viewMaxCol - viewMinCol + 1;
+    if (rowCount > MAX_VIEW_SIZE || colCount > MAX_VIEW_SIZE)
+    {
+        int minRow = 0, maxRow = 0, minCol = 0, maxCol = 0;
+        bool first = true;
+        // 窗口跟随本次实际要画出的轨迹
+        const Trajectory *shown[] = {&actualTrajectory, &relativeTrajectory, &predictedPath};
+        if (showFinalTrajectory)
+        {
+            shown[0] = &finalTrajectory;
+            shown[1] = &predictedPath;
+        }
+        for (const Trajectory *trajectory : shown)
+        {
+            for (const GridCell &cell : *trajectory)
+            {
+                GridCell screen = toScreen(cell, isComplexMode);
+                if (first)
+                {
+                    minRow = maxRow = screen.getRow();
+                    minCol = maxCol = screen.getCol();
+                    first = false;
+                }
+                minRow = min(minRow, screen.getRow());
+                maxRow = max(maxRow, screen.getRow());
+                minCol = min(minCol, screen.getCol());
+                maxCol = max(maxCol, screen.getCol());
+            }
+        }
+        if (rowCount > MAX_VIEW_SIZE)
+        {
+            rowCount = MAX_VIEW_SIZE;
+            viewMinRow = (minRow + maxRow) / 2 - MAX_VIEW_SIZE / 2;
+        }
+        if (colCount > MAX_VIEW_SIZE)
+        {
+            colCount = MAX_VIEW_SIZE;
+            viewMinCol = (minCol + maxCol) / 2 - MAX_VIEW_SIZE / 2;
+        }
+    }
+
+    // 创建一个空的网格
+    vector<vector<string>> grid(rowCount, vector<string>(colCount, "."));
 
     // 实际上可视化是靠一个二维vector存储得来的
 
@@ -145,14 +183,14 @@ void displayTrajectories(const GameObject &objectA, const Trajectory &predictedP
     {
         for (size_t i = 0; i < actualTrajectory.getLength(); i++)
         {
-            const GridCell &cell = actualTrajectory.getCell(i);
-            int row = cell.getRow() + OFFSET;
-            int col = cell.getCol() + OFFSET;
+            GridCell cell = toScreen(actualTrajectory[i], isComplexMode);
+            int row = cell.getRow() - viewMinRow;
+            int col = cell.getCol() - viewMinCol;
 
             // 确保在网格范围内
             if (!isComplexMode)
             {
-                if (row >= 0 && row < GRID_SIZE && col >= 0 && col < GRID_SIZE)
+                if (row >= 0 && row < rowCount && col >= 0 && col < colCount)
                 {
                     string marker = "A" + to_string(i % 10); // 使用数字标记顺序
                     grid[row][col] = marker;
@@ -160,14 +198,14 @@ void displayTrajectories(const GameObject &objectA, const Trajectory &predictedP
             }
             else
             {
-                if (row >= 0 && row < GRID_SIZE && col >= 0 && col < GRID_SIZE)
+                if (row >= 0 && row < rowCount && col >= 0 && col < colCount)
                 {
                     string marker = "A" + to_string(i % 10); // 使用数字标记顺序
                     for (int j = 0; j < 8; j++)
                     {
                         int gridX = row + hex_point[j].getRow();
                         int gridY = col + hex_point[j].getCol();
-                        if (gridX >= 0 && gridX < GRID_SIZE && gridY >= 0 && gridY < GRID_SIZE && grid[gridX][gridY] == ".")
+                        if (gridX >= 0 && gridX < rowCount && gridY >= 0 && gridY < colCount && grid[gridX][gridY] == ".")
                         {
                             grid[gridX][gridY] = "#";
                         }
@@ -183,12 +221,12 @@ void displayTrajectories(const GameObject &objectA, const Trajectory &predictedP
     {
         for (size_t i = 0; i < relativeTrajectory.getLength(); i++)
         {
-            const GridCell &cell = relativeTrajectory.getCell(i);
-            int row = cell.getRow() + OFFSET;
-            int col = cell.getCol() + OFFSET;
+            GridCell cell = toScreen(relativeTrajectory[i], isComplexMode);
+            int row = cell.getRow() - viewMinRow;
+            int col = cell.getCol() - viewMinCol;
 
             // 确保在网格范围内
-            if (row >= 0 && row < GRID_SIZE && col >= 0 && col < GRID_SIZE)
+            if (row >= 0 && row < rowCount && col >= 0 && col < colCount)
             {
                 string marker = "R" + to_string(i % 10);
                 // 如果已经有标记，表示重叠
@@ -214,7 +252,7 @@ void displayTrajectories(const GameObject &objectA, const Trajectory &predictedP
                     {
                         int gridX = row + hex_point[j].getRow();
                         int gridY = col + hex_point[j].getCol();
-                        if (gridX >= 0 && gridX < GRID_SIZE && gridY >= 0 && gridY < GRID_SIZE && grid[gridX][gridY] == ".")
+                        if (gridX >= 0 && gridX < rowCount && gridY >= 0 && gridY < colCount && grid[gridX][gridY] == ".")
                         {
                             grid[gridX][gridY] = "&";
                         }
@@ -228,14 +266,14 @@ void displayTrajectories(const GameObject &objectA, const Trajectory &predictedP
     // 填充网格 - 预测轨迹 (使用 P0, P1, P2, ...)
     for (size_t i = 0; i < predictedPath.getLength(); i++)
     {
-        const GridCell &cell = predictedPath.getCell(i);
+        GridCell cell = toScreen(predictedPath[i], isComplexMode);
         // 添加安全检查，确保i不超过finalTrajectory的长度
         bool canCompareWithWishCell = (i < finalTrajectory.getLength());
-        int row = cell.getRow() + OFFSET;
-        int col = cell.getCol() + OFFSET;
+        int row = cell.getRow() - viewMinRow;
+        int col = cell.getCol() - viewMinCol;
 
         // 确保在网格范围内
-        if (row >= 0 && row < GRID_SIZE && col >= 0 && col < GRID_SIZE)
+        if (row >= 0 && row < rowCount && col >= 0 && col < colCount)
         {
             string marker = "P" + to_string(i % 10);
             // 处理重叠情况
@@ -261,7 +299,7 @@ void displayTrajectories(const GameObject &objectA, const Trajectory &predictedP
                 {
                     int gridX = row + hex_point[j].getRow();
                     int gridY = col + hex_point[j].getCol();
-                    if (gridX >= 0 && gridX < GRID_SIZE && gridY >= 0 && gridY < GRID_SIZE && grid[gridX][gridY] == ".")
+                    if (gridX >= 0 && gridX < rowCount && gridY >= 0 && gridY < colCount && grid[gridX][gridY] == ".")
                     {
                         grid[gridX][gridY] = "&";
                     }
@@ -284,14 +322,15 @@ void displayTrajectories(const GameObject &objectA, const Trajectory &predictedP
     std::cout << "数字表示轨迹中点的顺序 (0-9循环)" << endl;
 
     // 打印坐标轴标签
-    std::cout << "\n坐标范围：X轴和Y轴从 " << MIN_COORD << " 到 " << MAX_COORD << endl;
+    std::cout << "\n坐标范围：行从 " << viewMinRow << " 到 " << viewMinRow + rowCount - 1
+              << "，列从 " << viewMinCol << " 到 " << viewMinCol + colCount - 1 << endl;
 
     // 打印网格内容 - 修正行标签对齐
-    for (int i = 0; i < GRID_SIZE; i++)
+    for (int i = 0; i < rowCount; i++)
     {
         if (i % 5 == 0)
         {
-            int originalCoord = MIN_GRID_COORD + (i);
+            int originalCoord = viewMinRow + (i);
             cout << setw(5) << originalCoord << " "; // 统一使用5个字符宽度
         }
         else
@@ -299,7 +338,7 @@ void displayTrajectories(const GameObject &objectA, const Trajectory &predictedP
             cout << "      "; // 保持6个字符的空间
         }
 
-        for (int j = 0; j < GRID_SIZE; j++)
+        for (int j = 0; j < colCount; j++)
         {
             cout << setw(2) << grid[i][j] << " ";
         }
@@ -310,7 +349,7 @@ void displayTrajectories(const GameObject &objectA, const Trajectory &predictedP
     cout << "\n系统生成的实际轨迹（通过计算得到）：" << endl;
     for (size_t i = 0; i < finalTrajectory.getLength(); i++)
     {
-        const GridCell &cell = finalTrajectory.getCell(i);
+        GridCell cell = toScreen(finalTrajectory[i], isComplexMode);
         cout << "  点" << i << ": 原始坐标("
              << cell.getRow() << "," << cell.getCol() << ")" << endl;
     }
@@ -322,14 +361,19 @@ Trajectory inputPrediction(const GameObject &objectA, int steps, bool isComplexM
     Trajectory prediction;
     const Trajectory &finalTrajectory = objectA.getfinalTrajectory();
     int finalLength = finalTrajectory.getLength();
+    // 玩家总是输入屏幕上的行列坐标，复杂模式下再换算成轴坐标存入预测轨迹
+    const BoardConfig &board = objectA.getBoard(isComplexMode ? TOPOLOGY_HEX : TOPOLOGY_SQUARE);
+    int minRow, maxRow, minCol, maxCol;
+    getInputRange(board, isComplexMode, minRow, maxRow, minCol, maxCol);
 
     std::cout << "请输入预测轨迹（" << steps << "步）" << std::endl;
 
     // 预测轨迹的起始点要求和电脑通过actualTrajectory和
     // RelativeTrajectory计算得出的finalTrajectory的起始点一致。
     prediction.addCell(finalTrajectory.getCell(0));
-    cout << "起始点行坐标（相对于中心0）：" << prediction.getCurrentCell().getRow() << endl;
-    cout << "起始点列坐标（相对于中心0）：" << prediction.getCurrentCell().getCol() << endl;
+    GridCell start = toScreen(prediction.getCurrentCell(), isComplexMode);
+    cout << "起始点行坐标（相对于中心0）：" << start.getRow() << endl;
+    cout << "起始点列坐标（相对于中心0）：" << start.getCol() << endl;
 
     // 输入每一步的方向
     for (int i = 0; i < steps; i++)
@@ -344,28 +388,42 @@ Trajectory inputPrediction(const GameObject &objectA, int steps, bool isComplexM
             cout << "\n已输入的预测坐标:" << endl;
             for (size_t j = 1; j < prediction.getLength(); j++)
             { // 从索引1开始，跳过起始点
-                const GridCell &cell = prediction.getCell(j);
+                GridCell cell = toScreen(prediction.getCell(j), isComplexMode);
                 cout << "  步骤 " << j << ": (" << cell.getRow() << ", " << cell.getCol() << ")" << endl;
             }
         }
 
         cout << "\n当前输入第 " << (i + 1) << " 步的坐标" << endl;
-        cout << "请输入下一个位置的行坐标（-30到30之间）：";
+        cout << "请输入下一个位置的行坐标（" << minRow << "到" << maxRow << "之间）：";
         cin >> x;
-        cout << "请输入下一个位置的列坐标（-30到30之间）：";
+        cout << "请输入下一个位置的列坐标（" << minCol << "到" << maxCol << "之间）：";
         cin >> y;
 
-        // 添加输入验证
-        while (x < -30 || x > 30 || y < -30 || y > 30)
+        // 添加输入验证：复杂模式下还要求坐标落在六边形网格上
+        HexCell hex;
+        while (true)
         {
-            cout << "\n坐标超出范围！请重新输入（-30到30之间）" << endl;
+            bool inRange = x >= minRow && x <= maxRow && y >= minCol && y <= maxCol;
+            if (inRange && (!isComplexMode || HexCell::fromOffset(GridCell(x, y), hex)))
+            {
+                break;
+            }
+            if (!inRange)
+            {
+                cout << "\n坐标超出范围！请重新输入（行" << minRow << "到" << maxRow
+                     << "之间，列" << minCol << "到" << maxCol << "之间）" << endl;
+            }
+            else
+            {
+                cout << "\n该位置不是六边形格子的中心！请重新输入" << endl;
+            }
             cout << "行坐标：";
             cin >> x;
             cout << "列坐标：";
             cin >> y;
         }
 
-        GridCell newCell(x, y);
+        GridCell newCell = isComplexMode ? hex.toCell() : GridCell(x, y);
         prediction.addCell(newCell);
     }
     displayTrajectories(objectA, prediction, isComplexMode, false);
@@ -374,7 +432,7 @@ Trajectory inputPrediction(const GameObject &objectA, int steps, bool isComplexM
     cout << "\n完整的预测轨迹坐标:" << endl;
     for (size_t i = 0; i < prediction.getLength(); i++)
     {
-        const GridCell &cell = prediction.getCell(i);
+        GridCell cell = toScreen(prediction.getCell(i), isComplexMode);
         cout << "  点 " << i << ": (" << cell.getRow() << ", " << cell.getCol() << ")" << endl;
     }
 
@@ -439,6 +497,7 @@ void runSinglePlayerGame(GameManager &gameManager)
     cout << "A - 参考轨迹(蓝色物体的运动)" << endl;
     cout << "R - 相对轨迹(红色物体相对于蓝色物体的运动)" << endl;
     cout << "\n请预测红色物体在实际坐标系中的运动轨迹" << endl;
+    cout << "本局难度: " << PuzzleDifficulty::getBandName(objectA.getDifficulty().band) << endl;
 
     int predictionSteps = 10;
     Trajectory userPrediction = inputPrediction(objectA, predictionSteps, isComplexMode);
@@ -570,6 +629,209 @@ void runSinglePlayerGame(GameManager &gameManager)
 #endif
 }
 
+// 三维轨迹的切片显示：按层逐一打印二维网格，每层只显示经过该层的单元格
+// 网格范围按所有轨迹的包围盒确定，避免打印大量空白
+void displayTrajectories3(const GameObject3 &object, const Trajectory3 &predictedPath, bool showFinalTrajectory)
+{
+    const Trajectory3 &actualTrajectory = object.getActualTrajectory();
+    const Trajectory3 &relativeTrajectory = object.getRelativeTrajectory();
+    const Trajectory3 &finalTrajectory = object.getfinalTrajectory();
+
+    // 需要显示的轨迹及其标记字母
+    vector<pair<const Trajectory3 *, char>> layers;
+    if (showFinalTrajectory)
+    {
+        layers.push_back(make_pair(&finalTrajectory, 'F'));
+    }
+    else
+    {
+        layers.push_back(make_pair(&actualTrajectory, ACTUAL_PATH));
+        layers.push_back(make_pair(&relativeTrajectory, RELATIVE_PATH));
+    }
+    layers.push_back(make_pair(&predictedPath, PREDICTED_PATH));
+
+    // 计算包围盒
+    int minRow = 0, maxRow = 0, minCol = 0, maxCol = 0, minLayer = 0, maxLayer = 0;
+    bool first = true;
+    for (size_t t = 0; t < layers.size(); t++)
+    {
+        for (const GridCell3 &cell : *layers[t].first)
+        {
+            if (first)
+            {
+                minRow = maxRow = cell.getRow();
+                minCol = maxCol = cell.getCol();
+                minLayer = maxLayer = cell.getLayer();
+                first = false;
+                continue;
+            }
+            minRow = min(minRow, cell.getRow());
+            maxRow = max(maxRow, cell.getRow());
+            minCol = min(minCol, cell.getCol());
+            maxCol = max(maxCol, cell.getCol());
+            minLayer = min(minLayer, cell.getLayer());
+            maxLayer = max(maxLayer, cell.getLayer());
+        }
+    }
+    if (first)
+    {
+        return;
+    }
+
+    int rows = maxRow - minRow + 1;
+    int cols = maxCol - minCol + 1;
+    for (int layer = minLayer; layer <= maxLayer; layer++)
+    {
+        vector<vector<string>> grid(rows, vector<string>(cols, "."));
+        bool used = false;
+        for (size_t t = 0; t < layers.size(); t++)
+        {
+            const Trajectory3 &trajectory = *layers[t].first;
+            for (size_t i = 0; i < trajectory.getLength(); i++)
+            {
+                const GridCell3 &cell = trajectory[i];
+                if (cell.getLayer() != layer)
+                {
+                    continue;
+                }
+                string &slot = grid[cell.getRow() - minRow][cell.getCol() - minCol];
+                string marker = string(1, layers[t].second) + to_string(i % 10);
+                // 同一格出现多条轨迹时显示重叠标记
+                slot = (slot == ".") ? marker : string(1, OVERLAP_ALL) + to_string(i % 10);
+                used = true;
+            }
+        }
+        if (!used)
+        {
+            continue;
+        }
+
+        cout << "\n--- 第 " << layer << " 层（行 " << minRow << "~" << maxRow
+             << "，列 " << minCol << "~" << maxCol << "）---" << endl;
+        for (int r = 0; r < rows; r++)
+        {
+            for (int c = 0; c < cols; c++)
+            {
+                cout << setw(3) << grid[r][c];
+            }
+            cout << endl;
+        }
+    }
+}
+
+// 手动输入三维预测轨迹
+Trajectory3 inputPrediction3(const GameObject3 &object, int steps)
+{
+    Trajectory3 prediction;
+    const Trajectory3 &finalTrajectory = object.getfinalTrajectory();
+
+    std::cout << "请输入预测轨迹（" << steps << "步）" << std::endl;
+
+    // 起始点与最终轨迹一致
+    prediction.addCell(finalTrajectory.getCell(0));
+    const GridCell3 &start = prediction.getCurrentCell();
+    cout << "起始点坐标（行, 列, 层）：(" << start.getRow() << ", " << start.getCol() << ", " << start.getLayer() << ")" << endl;
+
+    for (int i = 0; i < steps; i++)
+    {
+        displayTrajectories3(object, prediction, false);
+
+        cout << "\n当前输入第 " << (i + 1) << " 步的坐标" << endl;
+        int x, y, z;
+        cout << "请输入下一个位置的行坐标（-30到30之间）：";
+        cin >> x;
+        cout << "请输入下一个位置的列坐标（-30到30之间）：";
+        cin >> y;
+        cout << "请输入下一个位置的层坐标（-30到30之间）：";
+        cin >> z;
+
+        while (x < -30 || x > 30 || y < -30 || y > 30 || z < -30 || z > 30)
+        {
+            cout << "\n坐标超出范围！请重新输入（-30到30之间）" << endl;
+            cout << "行坐标：";
+            cin >> x;
+            cout << "列坐标：";
+            cin >> y;
+            cout << "层坐标：";
+            cin >> z;
+        }
+
+        prediction.addCell(GridCell3(x, y, z));
+    }
+
+    cout << "\n完整的预测轨迹坐标:" << endl;
+    for (size_t i = 0; i < prediction.getLength(); i++)
+    {
+        const GridCell3 &cell = prediction[i];
+        cout << "  点 " << i << ": (" << cell.getRow() << ", " << cell.getCol() << ", " << cell.getLayer() << ")" << endl;
+    }
+
+    return prediction;
+}
+
+// 运行三维单人游戏
+void runThreeDimensionalGame(GameManager &gameManager)
+{
+    const GameObject3 &object = gameManager.getObject3D();
+
+    cout << "\n初始轨迹（按层切片显示）：" << endl;
+    cout << "A - 参考轨迹(蓝色物体的运动)" << endl;
+    cout << "R - 相对轨迹(红色物体相对于蓝色物体的运动)" << endl;
+    cout << "\n请预测红色物体在实际坐标系中的运动轨迹" << endl;
+
+    Trajectory3 userPrediction = inputPrediction3(object, gameManager.getGameSteps());
+
+    double similarity = userPrediction.calculateSimilarity(object.getfinalTrajectory());
+    cout << "相似度: " << similarity * 100 << "%" << endl;
+    int score = similarity * 1000;
+    gameManager.getCurrentPlayer().addScore(score);
+    cout << "得分: " << score << endl;
+
+    cout << "\n正确答案：" << endl;
+    displayTrajectories3(object, userPrediction, true);
+
+    string playerName = gameManager.getCurrentPlayer().getName();
+    if (playerName.empty() && gameManager.isUserLoggedIn())
+    {
+        playerName = gameManager.getLoggedInUsername();
+    }
+    savePlayerScore(playerName.empty() ? "未知玩家" : playerName, "THREE_D_SINGLE", score);
+
+    cout << "\n=== 游戏结束 ===" << endl;
+    cout << "最终得分: " << score << endl;
+
+    cout << "\n按任意键继续..." << endl;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    cin.get();
+
+#if defined(_WIN32)
+    system("cls");
+#else
+    system("clear");
+#endif
+}
+
+// 选择二维模式的谜题难度，输入0或无效时不限难度
+void chooseDifficulty(GameManager &gameManager)
+{
+    cout << "请选择谜题难度：0. 不限";
+    for (int band = 0; band < PuzzleDifficulty::BAND_COUNT; band++)
+    {
+        cout << "  " << band + 1 << ". " << PuzzleDifficulty::getBandName(band);
+    }
+    cout << ": ";
+    int choice = 0;
+    cin >> choice;
+    if (choice >= 1 && choice <= PuzzleDifficulty::BAND_COUNT)
+    {
+        gameManager.setPuzzleDifficulty(choice - 1);
+    }
+    else
+    {
+        gameManager.setPuzzleDifficulty(GameManager::ANY_DIFFICULTY);
+    }
+}
+
 void BeginGame(GameManager &gameManager, string username)
 {
     int gameMode;
@@ -582,7 +844,8 @@ void BeginGame(GameManager &gameManager, string username)
     cout << "3. 简单多人模式" << endl;
     cout << "4. 复杂多人模式" << endl;
     cout << "5. 计时多人模式" << endl;
-    cout << "6. 返回主菜单" << endl;
+    cout << "6. 三维单人模式" << endl;
+    cout << "7. 返回主菜单" << endl;
     cout << "请选择: ";
     cin >> gameMode;
 
@@ -596,6 +859,7 @@ void BeginGame(GameManager &gameManager, string username)
             username = gameManager.getLoggedInUsername();
         }
 
+        chooseDifficulty(gameManager);
         gameManager.initializeGame(GameManager::SIMPLE_SINGLE, username, "");
         cout << "\n=== " << "简单" << "单人游戏开始 ===" << endl;
         cout << "当前玩家: " << username << endl;
@@ -611,6 +875,7 @@ void BeginGame(GameManager &gameManager, string username)
             username = gameManager.getLoggedInUsername();
         }
 
+        chooseDifficulty(gameManager);
         gameManager.initializeGame(GameManager::COMPLEX_SINGLE, username, "");
         cout << "\n=== " << "复杂" << "单人游戏开始 ===" << endl;
         cout << "当前玩家: " << username << endl;
@@ -659,6 +924,9 @@ void BeginGame(GameManager &gameManager, string username)
             }
         }
 
+        // 两名玩家做同一局谜题，难度由玩家1选择
+        chooseDifficulty(gameManager);
+
         // 根据选择初始化对应的多人游戏模式
         if (gameMode == 3)
         {
@@ -677,6 +945,34 @@ void BeginGame(GameManager &gameManager, string username)
         }
         break;
     case 6:
+        if (gameManager.isUserLoggedIn() && username.empty())
+        {
+            username = gameManager.getLoggedInUsername();
+        }
+
+        {
+            // 选择邻域：二十六邻域允许沿棱、角的对角线移动，更难预测
+            int lattice = 1;
+            cout << "请选择移动方式：1. 六邻域（沿坐标轴）  2. 二十六邻域（含对角线，更难）: ";
+            cin >> lattice;
+            gameManager.setTopology3(lattice == 2 ? TOPOLOGY3_FULL : TOPOLOGY3_FACE);
+        }
+        gameManager.initializeGame(GameManager::THREE_D_SINGLE, username, "");
+        cout << "\n=== " << "三维" << "单人游戏开始 ===" << endl;
+        cout << "当前玩家: " << username << endl;
+        if (gameManager.getTopology3() == TOPOLOGY3_FULL)
+        {
+            cout << "游戏原理：电脑在立方体网格中生成轨迹A和轨迹B相对A的相对路径，每步沿二十六个方向之一移动" << endl;
+        }
+        else
+        {
+            cout << "游戏原理：电脑在立方体网格中生成轨迹A和轨迹B相对A的相对路径，每步沿六个方向之一移动" << endl;
+        }
+        cout << "玩家任务是预测轨迹B在实际坐标系中的运动路径\n"
+             << endl;
+        runThreeDimensionalGame(gameManager);
+        break;
+    case 7:
         // 直接返回主菜单
         return;
     default:
@@ -708,13 +1004,29 @@ void BeginGame(GameManager &gameManager, string username)
     // 函数结束返回主菜单
 }
 
-int main()
+int main(int argc, char* argv[])
 {
-    srand(static_cast<unsigned int>(time(0)));
 #if defined(_WIN32)
     // 切换控制台到 UTF-8
     SetConsoleOutputCP(CP_UTF8);
     SetConsoleCP(CP_UTF8);
+#endif
+    // 离线生成题库：--build-bank <文件> [每个分区的谜题数]
+    if (argc >= 3 && string(argv[1]) == "--build-bank")
+    {
+        size_t perSection = argc >= 4 ? static_cast<size_t>(strtoul(argv[3], nullptr, 10)) : 10000;
+        GameManager builder;
+        // 构造时自动映射了默认题库，生成的可能正是这个文件，先关闭
+        builder.closePuzzleBank();
+        if (!builder.buildPuzzleBank(argv[2], perSection, builder.getSeed()))
+        {
+            cout << "题库生成失败: " << argv[2] << endl;
+            return 1;
+        }
+        cout << "题库已生成: " << argv[2] << endl;
+        return 0;
+    }
+#if defined(_WIN32)
     // 启动时清屏
     system("cls");
 #else
@@ -910,7 +1222,6 @@ void runMultiplayerGame(GameManager &gameManager)
         cout << "当前玩家: " << gameManager.getCurrentPlayer().getName() << endl;
 
         // 生成游戏数据
-        srand(static_cast<unsigned int>(time(nullptr) + gameManager.getCurrentRound()));
         gameManager.generateGameData();
 
         // 开始计时
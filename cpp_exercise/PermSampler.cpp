@@ -0,0 +1,172 @@
+#include "PermSampler.h"
+#include "DirectionMask.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+using namespace std;
+
+namespace {
+
+const double NEG_INF = -numeric_limits<double>::infinity();
+
+// 富集与剪枝的阈值（相对同长度的平均权重）
+const double LOG_UPPER = log(3.0);
+const double LOG_LOWER = log(0.3);
+
+// log(e^a + e^b)
+double logAdd(double a, double b) {
+    if (a == NEG_INF) return b;
+    if (b == NEG_INF) return a;
+    double hi = max(a, b);
+    return hi + log1p(exp(min(a, b) - hi));
+}
+
+} // namespace
+
+PermSampler::PermSampler() {
+    stats = Stats{0, 0, 0, 0.0, 0.0, 0.0, 0.0};
+}
+
+const PermSampler::Stats& PermSampler::getStats() const {
+    return stats;
+}
+
+bool PermSampler::sample(RandomEngine& random, Trajectory& trajectory, int steps, TopologyKind topology,
+                         const BoardConfig& board) {
+    auto start = chrono::steady_clock::now();
+    stats = Stats{0, 0, 0, 0.0, 0.0, 0.0, 0.0};
+    bool success = visitTopology(topology, [&](auto t) {
+        return run<decltype(t)>(random, trajectory, steps, board);
+    });
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    stats.samplesPerSecond = stats.seconds > 0 ? stats.completions / stats.seconds : 0.0;
+    return success;
+}
+
+template <typename Topology>
+bool PermSampler::run(RandomEngine& random, Trajectory& trajectory, int steps, const BoardConfig& board) {
+    if (steps <= 0) {
+        stats.completions = 1;
+        stats.effectiveSamples = 1.0;
+        return true;
+    }
+    if (trajectory.getLength() == 0) {
+        return false;
+    }
+
+    // 起点所在的空闲区域放不下整条轨迹时直接失败，不必耗尽生长预算
+    {
+        // 找到steps个空闲格子就停止，访问记录用哈希集合，与棋盘大小无关
+        CellHashSet visited;
+        vector<GridCell> queue(1, trajectory.getCurrentCell());
+        int reached = 0;
+        for (size_t head = 0; head < queue.size() && reached < steps; head++) {
+            for (int dir = 0; dir < Topology::DIRECTION_COUNT; dir++) {
+                GridCell next = queue[head] + Topology::DIRECTIONS[dir];
+                if (!board.contains(next)) continue;
+                if (visited.insert(next) != 1) continue;
+                if (trajectory.contains(next)) continue;
+                reached++;
+                queue.push_back(next);
+            }
+        }
+        if (reached < steps) {
+            return false;
+        }
+    }
+
+    frames.resize(steps + 1);
+    logWeightSum.assign(steps + 1, NEG_INF);
+    selected.clear();
+    double logTotal = NEG_INF;      // 完成轨迹的权重和
+    double logTotalSquare = NEG_INF; // 完成轨迹的权重平方和
+
+    // 进入第level层：累计平均权重，决定富集/剪枝，并准备这一层的帧
+    auto enter = [&](int level, double logWeight) {
+        Frame& frame = frames[level];
+        logWeightSum[level] = logAdd(logWeightSum[level], logWeight);
+
+        if (level == steps) {
+            // 到达目标长度：按权重做蓄水池抽样
+            stats.completions++;
+            logTotal = logAdd(logTotal, logWeight);
+            logTotalSquare = logAdd(logTotalSquare, 2 * logWeight);
+            if (random.nextDouble() < exp(logWeight - logTotal)) {
+                selected.assign(trajectory.begin(), trajectory.end());
+                stats.logWeight = logWeight;
+            }
+            frame.untried = 0;
+            frame.copiesLeft = 0;
+            return;
+        }
+
+        // 空闲方向：在棋盘内且未被占用（反方向是上一格，必然已被占用）
+        const GridCell& cell = trajectory.getCurrentCell();
+        uint32_t mask = 0;
+        for (int dir = 0; dir < Topology::DIRECTION_COUNT; dir++) {
+            GridCell next = cell + Topology::DIRECTIONS[dir];
+            mask |= static_cast<uint32_t>(board.contains(next) & !trajectory.contains(next)) << dir;
+        }
+        int freeCount = DirectionMask::countBits(mask);
+
+        int copies = freeCount > 0 ? 1 : 0;
+        if (freeCount > 0 && stats.tours > 1) {
+            double logMean = logWeightSum[level] - log(static_cast<double>(stats.tours));
+            if (logWeight > logMean + LOG_UPPER) {
+                // 富集：展开两个不同的方向，权重平分
+                copies = min(2, freeCount);
+            } else if (logWeight < logMean + LOG_LOWER) {
+                // 剪枝：一半概率丢弃，保留时权重加倍以保持无偏
+                if (random.nextDouble() < 0.5) {
+                    copies = 0;
+                } else {
+                    logWeight += log(2.0);
+                }
+            }
+        }
+        frame.untried = mask;
+        frame.copiesLeft = copies;
+        frame.childLogWeight = copies > 0 ? logWeight + log(static_cast<double>(freeCount)) - log(static_cast<double>(copies)) : NEG_INF;
+    };
+
+    while (stats.completions < TARGET_COMPLETIONS && stats.nodes < MAX_NODES) {
+        stats.tours++;
+        int level = 0;
+        enter(0, 0.0);
+        while (true) {
+            if (stats.nodes >= MAX_NODES) {
+                // 富集的一次遍历可能展开很多结点，超出预算时放弃本次遍历，退回起点
+                for (; level > 0; level--) {
+                    trajectory.pop_back();
+                }
+                break;
+            }
+            Frame& frame = frames[level];
+            if (frame.copiesLeft == 0 || frame.untried == 0) {
+                if (level == 0) {
+                    break;
+                }
+                trajectory.pop_back();
+                level--;
+                continue;
+            }
+            frame.copiesLeft--;
+            int dir = DirectionMask::pickBit(random, frame.untried);
+            frame.untried &= ~(uint32_t(1) << dir);
+            trajectory.addCell(trajectory.getCurrentCell() + Topology::DIRECTIONS[dir]);
+            stats.nodes++;
+            level++;
+            enter(level, frame.childLogWeight);
+        }
+    }
+
+    if (selected.empty()) {
+        return false;
+    }
+    stats.effectiveSamples = exp(2 * logTotal - logTotalSquare);
+    for (size_t i = trajectory.getLength(); i < selected.size(); i++) {
+        trajectory.addCell(selected[i]);
+    }
+    return true;
+}
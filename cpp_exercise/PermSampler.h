@@ -0,0 +1,58 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "GridCell.h"
+#include "Trajectory.h"
+#include "Topology.h"
+#include "RandomEngine.h"
+#include "BoardConfig.h"
+#include "CellHashSet.h"
+
+// 剪枝-富集Rosenbluth采样（PERM），用于生成接近均匀分布的长自回避轨迹
+// 每一轮（tour）从起点出发做深度优先的Rosenbluth生长，权重相对同长度的平均权重偏高时
+// 复制分支（富集），偏低时以1/2概率丢弃、否则权重加倍（剪枝）
+// 到达目标长度的轨迹按权重做蓄水池抽样，最终返回的轨迹近似服从均匀分布
+class PermSampler {
+public:
+    // 一次采样的统计
+    struct Stats {
+        long tours;               // 进行的轮数
+        long nodes;               // 生长的总步数
+        long completions;         // 到达目标长度的轨迹数
+        double logWeight;         // 选中轨迹的对数权重
+        double effectiveSamples;  // 完成轨迹的有效样本数 (Σw)²/Σw²，越接近completions权重越均衡
+        double seconds;           // 耗时
+        double samplesPerSecond;  // 每秒得到的完成轨迹数
+    };
+
+    // 每次采样收集的完成轨迹数、以及最多生长的步数
+    static const long TARGET_COMPLETIONS = 16;
+    static const long MAX_NODES = 2000000;
+
+private:
+    struct Frame {
+        uint32_t untried;        // 还没有展开的空闲方向
+        int copiesLeft;          // 还要展开的副本数
+        double childLogWeight;   // 每个副本的对数权重
+    };
+
+    std::vector<Frame> frames;         // 显式栈，每层一帧
+    std::vector<double> logWeightSum;  // 各长度上所有轮次的权重和（对数）
+    std::vector<GridCell> selected;    // 蓄水池中当前选中的轨迹
+    Stats stats;
+
+    template <typename Topology>
+    bool run(RandomEngine& random, Trajectory& trajectory, int steps, const BoardConfig& board);
+
+public:
+    // 构造函数
+    PermSampler();
+
+    // trajectory中已有起点，采样成功时追加steps步并返回true，轨迹限制在board范围内
+    // 失败（超出生长预算仍没有完成的轨迹）时trajectory恢复原状
+    bool sample(RandomEngine& random, Trajectory& trajectory, int steps, TopologyKind topology,
+                const BoardConfig& board);
+
+    // 最近一次采样的统计
+    const Stats& getStats() const;
+};
@@ -0,0 +1,283 @@
+#include "PuzzleBank.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+const char BANK_MAGIC[4] = {'T', 'P', 'B', 'K'};
+
+// 一条记录占用的字节数
+uint64_t recordBytes(int steps) {
+    return 3 * (static_cast<uint64_t>(steps) + 1) * sizeof(GridCell);
+}
+
+} // namespace
+
+PuzzleBank::PuzzleBank()
+    : data(nullptr), fileSize(0), indexTopologies(0), indexSteps(0), indexDifficulties(0)
+#if defined(_WIN32)
+    , fileHandle(nullptr), mappingHandle(nullptr)
+#endif
+{
+}
+
+PuzzleBank::~PuzzleBank() {
+    close();
+}
+
+bool PuzzleBank::open(const string& path) {
+    close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(FileHeader))) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        CloseHandle(file);
+        return false;
+    }
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = static_cast<const unsigned char*>(view);
+    fileSize = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+        ::close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    // 映射建立后文件描述符就不再需要了
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    data = static_cast<const unsigned char*>(view);
+    fileSize = static_cast<size_t>(info.st_size);
+#endif
+
+    if (!validate()) {
+        close();
+        return false;
+    }
+    buildIndex();
+    return true;
+}
+
+void PuzzleBank::close() {
+    if (data == nullptr) {
+        return;
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(data);
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    munmap(const_cast<unsigned char*>(data), fileSize);
+#endif
+    data = nullptr;
+    fileSize = 0;
+    sectionIndex.clear();
+    indexTopologies = 0;
+    indexSteps = 0;
+    indexDifficulties = 0;
+}
+
+bool PuzzleBank::isOpen() const {
+    return data != nullptr;
+}
+
+const PuzzleBank::FileHeader* PuzzleBank::header() const {
+    return reinterpret_cast<const FileHeader*>(data);
+}
+
+const PuzzleBank::SectionEntry* PuzzleBank::sections() const {
+    return reinterpret_cast<const SectionEntry*>(data + sizeof(FileHeader));
+}
+
+bool PuzzleBank::validate() const {
+    const FileHeader* head = header();
+    if (memcmp(head->magic, BANK_MAGIC, sizeof(BANK_MAGIC)) != 0 || head->version != VERSION ||
+        head->sectionCount > MAX_SECTIONS) {
+        return false;
+    }
+    if (head->minCoord > head->maxCoord || head->minCoord < -BoardConfig::LIMIT || head->maxCoord > BoardConfig::LIMIT) {
+        return false;
+    }
+    uint64_t directoryEnd = sizeof(FileHeader) + uint64_t(head->sectionCount) * sizeof(SectionEntry);
+    if (directoryEnd > fileSize) {
+        return false;
+    }
+    // 只检查目录里的偏移和长度，记录本身在取题时才会被访问
+    for (uint32_t s = 0; s < head->sectionCount; s++) {
+        const SectionEntry& section = sections()[s];
+        uint64_t bytes = uint64_t(section.count) * recordBytes(section.steps);
+        if (section.count > MAX_SECTION_PUZZLES || section.offset < directoryEnd || section.offset % sizeof(GridCell) != 0 ||
+            section.offset > fileSize || bytes > fileSize - section.offset) {
+            return false;
+        }
+    }
+    return true;
+}
+
+BoardConfig PuzzleBank::getBoard() const {
+    if (!isOpen()) {
+        return BoardConfig();
+    }
+    return BoardConfig(header()->minCoord, header()->maxCoord);
+}
+
+void PuzzleBank::buildIndex() {
+    const SectionEntry* entries = sections();
+    uint32_t count = header()->sectionCount;
+    indexTopologies = 0;
+    indexSteps = 0;
+    indexDifficulties = 0;
+    for (uint32_t s = 0; s < count; s++) {
+        indexTopologies = max(indexTopologies, entries[s].topology + 1);
+        indexSteps = max(indexSteps, entries[s].steps + 1);
+        indexDifficulties = max(indexDifficulties, entries[s].difficulty + 1);
+    }
+    sectionIndex.assign(static_cast<size_t>(indexTopologies) * indexSteps * indexDifficulties, -1);
+    // 同一个(拓扑, 步数, 难度)出现多次时使用第一个分区
+    for (uint32_t s = count; s-- > 0;) {
+        size_t slot = (static_cast<size_t>(entries[s].topology) * indexSteps + entries[s].steps) * indexDifficulties +
+                      entries[s].difficulty;
+        sectionIndex[slot] = static_cast<int32_t>(s);
+    }
+}
+
+const PuzzleBank::SectionEntry* PuzzleBank::findSection(TopologyKind topology, int steps, int difficulty) const {
+    if (topology < 0 || topology >= indexTopologies || steps < 0 || steps >= indexSteps ||
+        difficulty < 0 || difficulty >= indexDifficulties) {
+        return nullptr;
+    }
+    int32_t s = sectionIndex[(static_cast<size_t>(topology) * indexSteps + steps) * indexDifficulties + difficulty];
+    return s < 0 ? nullptr : &sections()[s];
+}
+
+size_t PuzzleBank::getCount(TopologyKind topology, int steps, int difficulty) const {
+    const SectionEntry* section = findSection(topology, steps, difficulty);
+    return section == nullptr ? 0 : section->count;
+}
+
+bool PuzzleBank::getPuzzle(TopologyKind topology, int steps, int difficulty, size_t index, Puzzle& puzzle) const {
+    const SectionEntry* section = findSection(topology, steps, difficulty);
+    if (section == nullptr || index >= section->count) {
+        return false;
+    }
+    size_t stride = static_cast<size_t>(steps) + 1;
+    const GridCell* record = reinterpret_cast<const GridCell*>(data + section->offset) + index * 3 * stride;
+    puzzle.actualTrajectory = CellSpan(record, stride);
+    puzzle.relativeTrajectory = CellSpan(record + stride, stride);
+    puzzle.finalTrajectory = CellSpan(record + 2 * stride, stride);
+    return true;
+}
+
+bool PuzzleBank::write(const string& path, const vector<SectionSource>& sources, const BoardConfig& board) {
+    if (sources.size() > MAX_SECTIONS) {
+        return false;
+    }
+
+    // 先统计每个分区的完整谜题数，确定各分区的偏移
+    vector<SectionEntry> entries(sources.size());
+    uint64_t offset = sizeof(FileHeader) + uint64_t(sources.size()) * sizeof(SectionEntry);
+    for (size_t s = 0; s < sources.size(); s++) {
+        const PuzzleBatch& batch = *sources[s].batch;
+        if (sources[s].difficulty < 0 || sources[s].difficulty > MAX_DIFFICULTY || batch.getSteps() > 0xFFFF) {
+            return false;
+        }
+        uint32_t complete = 0;
+        for (size_t i = 0; i < batch.size(); i++) {
+            if (batch.isComplete(i)) {
+                complete++;
+            }
+        }
+        if (complete > MAX_SECTION_PUZZLES) {
+            return false;
+        }
+        entries[s].topology = static_cast<uint8_t>(batch.getTopology());
+        entries[s].difficulty = static_cast<uint8_t>(sources[s].difficulty);
+        entries[s].steps = static_cast<uint16_t>(batch.getSteps());
+        entries[s].count = complete;
+        entries[s].offset = offset;
+        offset += uint64_t(complete) * recordBytes(batch.getSteps());
+    }
+
+    string tempPath = path + ".tmp";
+    ofstream out(tempPath.c_str(), ios::binary | ios::trunc);
+    if (!out) {
+        return false;
+    }
+    FileHeader head;
+    memcpy(head.magic, BANK_MAGIC, sizeof(BANK_MAGIC));
+    head.version = VERSION;
+    head.sectionCount = static_cast<uint32_t>(sources.size());
+    head.minCoord = board.getMinCoord();
+    head.maxCoord = board.getMaxCoord();
+    head.reserved = 0;
+    out.write(reinterpret_cast<const char*>(&head), sizeof(head));
+    if (!entries.empty()) {
+        out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(SectionEntry));
+    }
+
+    for (size_t s = 0; s < sources.size(); s++) {
+        const PuzzleBatch& batch = *sources[s].batch;
+        size_t recordCells = 3 * (static_cast<size_t>(batch.getSteps()) + 1);
+        const GridCell* cells = batch.getCells().data();
+        for (size_t i = 0; i < batch.size(); i++) {
+            if (batch.isComplete(i)) {
+                out.write(reinterpret_cast<const char*>(cells + i * recordCells), recordCells * sizeof(GridCell));
+            }
+        }
+    }
+    out.close();
+    if (!out) {
+        remove(tempPath.c_str());
+        return false;
+    }
+
+    // 整个文件写完后再替换，正在使用旧题库的进程不会读到写了一半的文件
+#if defined(_WIN32)
+    bool replaced = MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    bool replaced = rename(tempPath.c_str(), path.c_str()) == 0;
+#endif
+    if (!replaced) {
+        remove(tempPath.c_str());
+    }
+    return replaced;
+}
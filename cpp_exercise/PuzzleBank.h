@@ -0,0 +1,102 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include "GridCell.h"
+#include "CellSpan.h"
+#include "Topology.h"
+#include "BoardConfig.h"
+#include "PuzzleBatch.h"
+
+// 离线生成的谜题库文件，启动时整体映射到内存，按(拓扑, 步数, 难度)直接取题
+// 打开时只校验文件头和分区目录、建立(拓扑, 步数, 难度)到分区的直接索引表，不读取记录，耗时与题库大小无关
+// 文件布局（本机字节序）：
+//   FileHeader
+//   SectionEntry[sectionCount]
+//   各分区的记录：每条记录为3*(steps+1)个GridCell，依次为参考轨迹、相对轨迹、实际轨迹
+class PuzzleBank {
+public:
+    // 一局谜题的三条轨迹，视图在题库关闭后失效
+    struct Puzzle {
+        CellSpan actualTrajectory;
+        CellSpan relativeTrajectory;
+        CellSpan finalTrajectory;
+    };
+
+    // 写入题库时的一个分区：批次中所有完整的谜题都归入同一难度
+    struct SectionSource {
+        const PuzzleBatch* batch;
+        int difficulty;
+    };
+
+    static const uint32_t VERSION = 3;   // 难度档的标定或轨迹坐标的表示改变时加一，旧题库不再适用
+    static const uint32_t MAX_SECTIONS = 4096;
+    static const int MAX_DIFFICULTY = 255;
+    static const uint32_t MAX_SECTION_PUZZLES = 1 << 24; // 几个分区的数量相加仍在int范围内
+
+private:
+    struct FileHeader {
+        char magic[4];         // "TPBK"
+        uint32_t version;
+        uint32_t sectionCount;
+        int32_t minCoord;      // 生成谜题时的棋盘范围
+        int32_t maxCoord;
+        uint32_t reserved;
+    };
+
+    struct SectionEntry {
+        uint8_t topology;
+        uint8_t difficulty;
+        uint16_t steps;
+        uint32_t count;        // 记录数
+        uint64_t offset;       // 第一条记录相对文件开头的偏移
+    };
+
+    const unsigned char* data; // 映射的文件内容
+    size_t fileSize;
+
+    // 直接索引表：下标为(拓扑 * indexSteps + 步数) * indexDifficulties + 难度，值为分区编号，-1表示没有
+    // 三个维度都只取到文件中出现的最大值
+    std::vector<int32_t> sectionIndex;
+    int indexTopologies;
+    int indexSteps;
+    int indexDifficulties;
+#if defined(_WIN32)
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+    const FileHeader* header() const;
+    const SectionEntry* sections() const;
+    const SectionEntry* findSection(TopologyKind topology, int steps, int difficulty) const;
+    bool validate() const;
+    void buildIndex();
+
+    PuzzleBank(const PuzzleBank&);
+    PuzzleBank& operator=(const PuzzleBank&);
+
+public:
+    // 构造函数
+    PuzzleBank();
+    ~PuzzleBank();
+
+    // 映射题库文件，文件不存在或格式不对时返回false（此前打开的题库会被关闭）
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const;
+
+    // 题库生成时使用的棋盘范围（未打开时为默认棋盘）
+    BoardConfig getBoard() const;
+
+    // 某个分区的谜题数量，没有该分区时为0
+    size_t getCount(TopologyKind topology, int steps, int difficulty) const;
+
+    // 取出分区中第index个谜题，没有该分区或index越界时返回false
+    bool getPuzzle(TopologyKind topology, int steps, int difficulty, size_t index, Puzzle& puzzle) const;
+
+    // 把若干批次写成题库文件（只写入完整的谜题），所有批次须在同一棋盘上生成
+    // 先写到path加".tmp"的临时文件，成功后再替换path，失败时原有的题库不受影响
+    // Windows上被映射的文件不能替换，写入前要先关闭映射了path的PuzzleBank
+    static bool write(const std::string& path, const std::vector<SectionSource>& sources, const BoardConfig& board);
+};
@@ -0,0 +1,177 @@
+#include "PuzzleBatch.h"
+#include "GameObject.h"
+#include "RandomEngine.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+// 把一条轨迹复制到缓冲区中的固定位置，返回复制的单元格数
+uint32_t copyTrajectory(const Trajectory& trajectory, GridCell* out, size_t stride) {
+    size_t length = min(trajectory.getLength(), stride);
+    copy(trajectory.begin(), trajectory.begin() + length, out);
+    return static_cast<uint32_t>(length);
+}
+
+} // namespace
+
+PuzzleBatch::PuzzleBatch()
+    : topology(TOPOLOGY_SQUARE), steps(0), seed(0), count(0), stride(1) {}
+
+uint64_t PuzzleBatch::puzzleSeed(uint64_t seed, size_t index) {
+    // 相邻编号的种子先经过一次混合，避免RandomEngine内部的splitmix序列彼此重叠
+    uint64_t z = seed + (static_cast<uint64_t>(index) + 1) * 0xD1B54A32D192ED03ull;
+    z = (z ^ (z >> 32)) * 0xDABA0B6EB09322E3ull;
+    z = (z ^ (z >> 32)) * 0xDABA0B6EB09322E3ull;
+    return z ^ (z >> 32);
+}
+
+PuzzleBatch PuzzleBatch::generate(size_t count, TopologyKind topology, int steps, uint64_t seed,
+                                  const BoardConfig& board, unsigned threads) {
+    if (steps < 0) {
+        throw invalid_argument("PuzzleBatch: steps must be non-negative");
+    }
+
+    PuzzleBatch batch;
+    batch.topology = topology;
+    batch.steps = steps;
+    batch.seed = seed;
+    batch.count = count;
+    batch.stride = static_cast<size_t>(steps) + 1;
+    batch.cells.resize(count * 3 * batch.stride);
+    batch.lengths.resize(count * 3);
+
+    // 线程数不超过块数，调用线程本身也参与生成
+    size_t chunks = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    if (threads == 0) {
+        threads = max(1u, thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(min<size_t>(threads, max<size_t>(chunks, 1)));
+
+    // 各线程从共享计数器领取下一块，先完成的线程自然多领，不需要预先划分
+    atomic<size_t> nextChunk(0);
+    atomic<bool> failed(false);
+    exception_ptr error;
+    mutex errorMutex;
+
+    auto work = [&]() {
+        try {
+            GameObject worker;
+            worker.setBoard(board);
+            for (;;) {
+                size_t chunk = nextChunk.fetch_add(1, memory_order_relaxed);
+                if (chunk >= chunks || failed.load(memory_order_relaxed)) {
+                    break;
+                }
+                size_t first = chunk * CHUNK_SIZE;
+                size_t last = min(first + CHUNK_SIZE, count);
+                for (size_t i = first; i < last; i++) {
+                    worker.setRandomEngine(RandomEngine(puzzleSeed(seed, i)));
+                    worker.generatePuzzle(topology, steps);
+
+                    GridCell* out = batch.cells.data() + i * 3 * batch.stride;
+                    uint32_t* length = batch.lengths.data() + i * 3;
+                    length[0] = copyTrajectory(worker.getActualTrajectory(), out, batch.stride);
+                    length[1] = copyTrajectory(worker.getRelativeTrajectory(), out + batch.stride, batch.stride);
+                    length[2] = copyTrajectory(worker.getfinalTrajectory(), out + 2 * batch.stride, batch.stride);
+                }
+            }
+        } catch (...) {
+            lock_guard<mutex> lock(errorMutex);
+            if (!error) {
+                error = current_exception();
+            }
+            failed = true;
+        }
+    };
+
+    vector<thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; t++) {
+        pool.emplace_back(work);
+    }
+    work();
+    for (size_t t = 0; t < pool.size(); t++) {
+        pool[t].join();
+    }
+
+    if (error) {
+        rethrow_exception(error);
+    }
+    return batch;
+}
+
+size_t PuzzleBatch::size() const {
+    return count;
+}
+
+int PuzzleBatch::getSteps() const {
+    return steps;
+}
+
+TopologyKind PuzzleBatch::getTopology() const {
+    return topology;
+}
+
+uint64_t PuzzleBatch::getSeed() const {
+    return seed;
+}
+
+CellSpan PuzzleBatch::trajectoryAt(size_t index, int which) const {
+    if (index >= count) {
+        throw out_of_range("PuzzleBatch index out of range");
+    }
+    size_t offset = index * 3 + which;
+    return CellSpan(cells.data() + offset * stride, lengths[offset]);
+}
+
+CellSpan PuzzleBatch::getActual(size_t index) const {
+    return trajectoryAt(index, 0);
+}
+
+CellSpan PuzzleBatch::getRelative(size_t index) const {
+    return trajectoryAt(index, 1);
+}
+
+CellSpan PuzzleBatch::getFinal(size_t index) const {
+    return trajectoryAt(index, 2);
+}
+
+bool PuzzleBatch::isComplete(size_t index) const {
+    if (index >= count) {
+        throw out_of_range("PuzzleBatch index out of range");
+    }
+    const uint32_t* length = lengths.data() + index * 3;
+    return length[0] == stride && length[1] == stride && length[2] == stride;
+}
+
+PuzzleBatch PuzzleBatch::select(const vector<size_t>& indices) const {
+    PuzzleBatch subset;
+    subset.topology = topology;
+    subset.steps = steps;
+    subset.seed = seed;
+    subset.count = indices.size();
+    subset.stride = stride;
+    subset.cells.resize(subset.count * 3 * stride);
+    subset.lengths.resize(subset.count * 3);
+    for (size_t i = 0; i < indices.size(); i++) {
+        if (indices[i] >= count) {
+            throw out_of_range("PuzzleBatch index out of range");
+        }
+        copy(cells.begin() + indices[i] * 3 * stride, cells.begin() + (indices[i] + 1) * 3 * stride,
+             subset.cells.begin() + i * 3 * stride);
+        copy(lengths.begin() + indices[i] * 3, lengths.begin() + (indices[i] + 1) * 3,
+             subset.lengths.begin() + i * 3);
+    }
+    return subset;
+}
+
+const std::vector<GridCell>& PuzzleBatch::getCells() const {
+    return cells;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "GridCell.h"
+#include "CellSpan.h"
+#include "Topology.h"
+#include "BoardConfig.h"
+
+// 批量生成的谜题，所有单元格连续存放在一块缓冲区中
+// 每个谜题占3*(steps+1)个单元格，依次为参考轨迹、相对轨迹、实际轨迹
+// 第i个谜题只使用由(seed, i)派生的随机序列，所以结果与线程数和调度顺序无关
+class PuzzleBatch {
+public:
+    // 工作线程每次从共享计数器领取的谜题数
+    static const size_t CHUNK_SIZE = 64;
+
+private:
+    TopologyKind topology;
+    int steps;
+    uint64_t seed;
+    size_t count;
+    size_t stride;                 // 每条轨迹的单元格数（steps+1）
+    std::vector<GridCell> cells;   // count*3*stride个单元格
+    std::vector<uint32_t> lengths; // 每个谜题三条轨迹实际生成的长度（生成失败时短于stride）
+
+    CellSpan trajectoryAt(size_t index, int which) const;
+
+public:
+    // 构造函数（空批次）
+    PuzzleBatch();
+
+    // 生成count个谜题，threads为0时使用全部硬件线程；steps为负时抛出invalid_argument
+    static PuzzleBatch generate(size_t count, TopologyKind topology, int steps, uint64_t seed,
+                                const BoardConfig& board = BoardConfig(), unsigned threads = 0);
+
+    // 第index个谜题使用的随机数种子
+    static uint64_t puzzleSeed(uint64_t seed, size_t index);
+
+    size_t size() const;
+    int getSteps() const;
+    TopologyKind getTopology() const;
+    uint64_t getSeed() const;
+
+    // 第index个谜题的三条轨迹（越界抛出out_of_range），视图在批次销毁后失效
+    CellSpan getActual(size_t index) const;
+    CellSpan getRelative(size_t index) const;
+    CellSpan getFinal(size_t index) const;
+
+    // 三条轨迹是否都达到了目标步数
+    bool isComplete(size_t index) const;
+
+    // 按indices的顺序取出其中的谜题组成新的批次（例如按难度分组），编号越界时抛出out_of_range
+    // 新批次第i个谜题不再对应puzzleSeed(seed, i)
+    PuzzleBatch select(const std::vector<size_t>& indices) const;
+
+    // 整块单元格缓冲区
+    const std::vector<GridCell>& getCells() const;
+};
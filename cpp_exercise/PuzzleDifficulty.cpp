@@ -0,0 +1,176 @@
+#include "PuzzleDifficulty.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// 默认棋盘和约束下每种拓扑、每个步数各4000局的标定结果。评分是离散的，分界取在相邻两个评分值之间，
+// 使低于分界的比例最接近1/4、1/2、3/4；步数很少时不同的谜题只有几种，做不到四档均分，有的档不会出现
+const double PuzzleDifficulty::BAND_LIMITS[PuzzleDifficulty::TOPOLOGY_COUNT][PuzzleDifficulty::CALIBRATED_STEPS]
+                                          [PuzzleDifficulty::BAND_COUNT - 1] = {
+    // 四方向
+    {
+        {0.0000, 0.1455, 0.1455},
+        {0.3222, 0.4222, 0.5222},
+        {0.3827, 0.4494, 0.5161},
+        {0.3974, 0.4641, 0.5141},
+        {0.4152, 0.4702, 0.5202},
+        {0.4312, 0.4778, 0.5245},
+        {0.4473, 0.4878, 0.5283},
+        {0.4568, 0.4961, 0.5354},
+        {0.4617, 0.5020, 0.5388},
+        {0.4720, 0.5097, 0.5431},
+        {0.4801, 0.5151, 0.5482},
+        {0.4844, 0.5193, 0.5526},
+        {0.4939, 0.5259, 0.5567},
+        {0.4993, 0.5334, 0.5642},
+        {0.5055, 0.5340, 0.5626},
+        {0.5090, 0.5390, 0.5674},
+        {0.5156, 0.5441, 0.5726},
+        {0.5186, 0.5467, 0.5761},
+        {0.5237, 0.5497, 0.5769},
+        {0.5282, 0.5545, 0.5803}
+    },
+    // 六方向
+    {
+        {0.0000, 0.1455, 0.1455},
+        {0.4222, 0.5222, 0.5222},
+        {0.4494, 0.4994, 0.5661},
+        {0.4641, 0.5307, 0.6141},
+        {0.4952, 0.5502, 0.6352},
+        {0.5045, 0.5712, 0.6512},
+        {0.5259, 0.5854, 0.6676},
+        {0.5390, 0.5997, 0.6818},
+        {0.5520, 0.6172, 0.7006},
+        {0.5653, 0.6297, 0.7164},
+        {0.5764, 0.6414, 0.7255},
+        {0.5859, 0.6541, 0.7329},
+        {0.5980, 0.6625, 0.7439},
+        {0.6048, 0.6741, 0.7521},
+        {0.6159, 0.6845, 0.7609},
+        {0.6232, 0.6940, 0.7699},
+        {0.6329, 0.6989, 0.7733},
+        {0.6389, 0.7101, 0.7794},
+        {0.6462, 0.7143, 0.7842},
+        {0.6550, 0.7245, 0.7908}
+    },
+    // 八方向
+    {
+        {0.0000, 0.1455, 0.1455},
+        {0.4222, 0.5222, 0.5222},
+        {0.4661, 0.5161, 0.5827},
+        {0.4974, 0.5474, 0.6141},
+        {0.5102, 0.5702, 0.6452},
+        {0.5312, 0.5912, 0.6712},
+        {0.5473, 0.6068, 0.6842},
+        {0.5568, 0.6176, 0.7033},
+        {0.5714, 0.6367, 0.7172},
+        {0.5897, 0.6520, 0.7342},
+        {0.5969, 0.6641, 0.7437},
+        {0.6071, 0.6723, 0.7480},
+        {0.6163, 0.6862, 0.7577},
+        {0.6268, 0.6982, 0.7730},
+        {0.6340, 0.7059, 0.7726},
+        {0.6457, 0.7149, 0.7824},
+        {0.6531, 0.7222, 0.7866},
+        {0.6637, 0.7304, 0.7918},
+        {0.6728, 0.7371, 0.7953},
+        {0.6766, 0.7429, 0.8029}
+    }
+};
+
+namespace {
+
+// 一条轨迹的转弯次数：相邻两步位移不同即为一次转弯
+int countTurns(CellSpan cells) {
+    int turns = 0;
+    for (size_t i = 2; i < cells.size(); i++) {
+        if (cells[i] - cells[i - 1] != cells[i - 1] - cells[i - 2]) {
+            turns++;
+        }
+    }
+    return turns;
+}
+
+} // namespace
+
+PuzzleDifficulty::Features PuzzleDifficulty::extract(TopologyKind topology, CellSpan actual, CellSpan relative,
+                                                     CellSpan composite) {
+    Features features = {0, 0, 0, 0, 0, 0, 0.0, 0};
+    features.turns = countTurns(actual) + countTurns(relative);
+    if (composite.size() < 2) {
+        features.band = 0;
+        return features;
+    }
+    int steps = static_cast<int>(composite.size()) - 1;
+    features.steps = steps;
+
+    // 连续相同位移的段
+    int run = 0;
+    for (int i = 1; i <= steps; i++) {
+        if (i > 1 && composite[i] - composite[i - 1] == composite[i - 1] - composite[i - 2]) {
+            run++;
+        } else {
+            features.runs++;
+            run = 1;
+        }
+        features.longestRun = max(features.longestRun, run);
+    }
+
+    // 按格子排序后二分查找：每个格子查它自己（是否回到走过的格子）和该拓扑下的每个相邻格子
+    vector<pair<uint32_t, int> > order(composite.size());
+    for (size_t i = 0; i < composite.size(); i++) {
+        order[i] = make_pair(composite[i].getSortKey(), static_cast<int>(i));
+    }
+    sort(order.begin(), order.end());
+    const int directionCount = getDirectionCount(topology);
+    const GridCell* directions = getDirections(topology);
+    for (int i = 0; i <= steps; i++) {
+        const GridCell& cell = composite[i];
+        bool revisited = false;
+        for (int dir = -1; dir < directionCount; dir++) {
+            uint32_t key = (dir < 0 ? cell : cell + directions[dir]).getSortKey();
+            vector<pair<uint32_t, int> >::const_iterator it =
+                lower_bound(order.begin(), order.end(), make_pair(key, 0));
+            // 每对位置只在较晚的一方统计一次；下标有序，遇到不早于i的就可以停止
+            for (; it != order.end() && it->first == key && it->second < i; ++it) {
+                if (dir < 0) {
+                    revisited = true;
+                } else if (it->second < i - 1) {
+                    features.contacts++;
+                }
+            }
+        }
+        features.doubleBacks += revisited ? 1 : 0;
+    }
+
+    // 各项归一化到[0, 1]后等权相加：转弯越多、位移变化越频繁、自身挨得越近、折返越多、步数越多越难
+    double changes = max(1, steps - 1);
+    double turnRate = features.turns / (2.0 * changes);
+    double changeRate = (features.runs - 1) / changes;
+    double proximity = min(1.0, static_cast<double>(features.contacts) / steps);
+    double doubleBackRate = static_cast<double>(features.doubleBacks) / steps;
+    double length = min(1.0, log2(1.0 + steps) / log2(1.0 + FULL_LENGTH_STEPS));
+    features.score = (turnRate + changeRate + proximity + doubleBackRate + length) / 5.0;
+    features.band = bandOf(topology, steps, features.score);
+    return features;
+}
+
+int PuzzleDifficulty::bandOf(TopologyKind topology, int steps, double score) {
+    if (steps <= 0 || topology < 0 || topology >= TOPOLOGY_COUNT) {
+        return 0;
+    }
+    const double* limits = BAND_LIMITS[topology][min(steps, CALIBRATED_STEPS) - 1];
+    int band = 0;
+    while (band < BAND_COUNT - 1 && score >= limits[band]) {
+        band++;
+    }
+    return band;
+}
+
+const char* PuzzleDifficulty::getBandName(int band) {
+    static const char* const NAMES[BAND_COUNT] = {"简单", "普通", "困难", "极难"};
+    return band >= 0 && band < BAND_COUNT ? NAMES[band] : "?";
+}
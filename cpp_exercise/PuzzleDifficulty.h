@@ -0,0 +1,45 @@
+#pragma once
+#include "CellSpan.h"
+#include "Topology.h"
+
+// 谜题难度：从（参考轨迹、相对轨迹、合成轨迹）三条轨迹中提取特征，合成为[0, 1]内的评分，
+// 再按评分划分为BAND_COUNT个难度档
+// 两个位置是否挨在一起按谜题的拓扑判断（六方向为六边形的六个相邻格子），题库中的谜题和实时生成的谜题用同一套标准
+class PuzzleDifficulty {
+public:
+    // 难度档数量：0简单、1普通、2困难、3极难
+    static const int BAND_COUNT = 4;
+
+    // 一局谜题的特征
+    struct Features {
+        int steps;          // 合成轨迹的步数
+        int turns;          // 参考轨迹和相对轨迹转弯次数之和
+        int runs;           // 合成轨迹中连续相同位移的段数
+        int longestRun;     // 最长一段的步数
+        int contacts;       // 合成轨迹上不相邻的两个位置挨在一起（相差该拓扑的一个单位步）的次数
+        int doubleBacks;    // 合成轨迹回到已经走过的格子的次数（含原地不动和原路折返）
+        double score;       // 综合评分，越大越难
+        int band;           // 难度档
+    };
+
+    // 提取特征并评分，轨迹为空时所有特征为0
+    static Features extract(TopologyKind topology, CellSpan actual, CellSpan relative, CellSpan composite);
+
+    // 某拓扑、某步数的谜题评分所在的难度档
+    static int bandOf(TopologyKind topology, int steps, double score);
+
+    // 难度档的名称，越界时返回"?"
+    static const char* getBandName(int band);
+
+private:
+    // 分界评分按拓扑和步数分别标定，超过CALIBRATED_STEPS步时使用CALIBRATED_STEPS步的分界
+    static const int TOPOLOGY_COUNT = 3;
+    static const int CALIBRATED_STEPS = 20;
+
+    // 难度档之间的分界评分：默认约束下每种拓扑、每个步数各生成一批谜题，取评分的四分位数，
+    // 所以每个模式、每个步数下四个难度档出现的机会大致相同
+    static const double BAND_LIMITS[TOPOLOGY_COUNT][CALIBRATED_STEPS][BAND_COUNT - 1];
+
+    // 评分中步数项达到满分时的步数
+    static const int FULL_LENGTH_STEPS = 20;
+};
@@ -0,0 +1,176 @@
+#include "PuzzleHash.h"
+#include "HexCell.h"
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+namespace {
+
+// 单步位移的编码：两个坐标各在[-1, 1]内，编码为(a + 1) * 3 + (b + 1)
+// 四方向、八方向用行列坐标，六方向用轴坐标(q, r)
+const int STEP_CODES = 9;
+const int PAIR_CODES = STEP_CODES * STEP_CODES;
+
+// 对称群最多12个元素（D6）
+const int MAX_SYMMETRIES = 12;
+
+int encodeStep(int a, int b) {
+    return (a + 1) * 3 + (b + 1);
+}
+
+// 对称群中每个元素对（参考位移, 相对位移）编码的置换表
+struct SymmetryTables {
+    int count;
+    uint8_t pairs[MAX_SYMMETRIES][PAIR_CODES];
+
+    // 由单步编码的置换表得到成对编码的置换表
+    void addElement(const int (&steps)[STEP_CODES]) {
+        for (int a = 0; a < STEP_CODES; a++) {
+            for (int b = 0; b < STEP_CODES; b++) {
+                pairs[count][a * STEP_CODES + b] = static_cast<uint8_t>(steps[a] * STEP_CODES + steps[b]);
+            }
+        }
+        count++;
+    }
+};
+
+// D4：行列位移旋转0、90、180、270度，每种再决定是否左右翻转
+SymmetryTables buildSquareTables() {
+    SymmetryTables tables;
+    tables.count = 0;
+    for (int rotation = 0; rotation < 4; rotation++) {
+        for (int reflect = 0; reflect < 2; reflect++) {
+            int steps[STEP_CODES];
+            for (int dr = -1; dr <= 1; dr++) {
+                for (int dc = -1; dc <= 1; dc++) {
+                    int r = dr, c = dc;
+                    for (int k = 0; k < rotation; k++) {
+                        int t = r;
+                        r = c;
+                        c = -t;
+                    }
+                    if (reflect) {
+                        c = -c;
+                    }
+                    steps[encodeStep(dr, dc)] = encodeStep(r, c);
+                }
+            }
+            tables.addElement(steps);
+        }
+    }
+    return tables;
+}
+
+// D6：立方坐标(q, r, s)旋转60度为(-r, -s, -q)，翻转为交换r和s
+// 六个单位步在变换下互相置换；(1, 1)和(-1, -1)不是单位步，不会出现在轨迹中，保持不变
+SymmetryTables buildHexTables() {
+    SymmetryTables tables;
+    tables.count = 0;
+    for (int rotation = 0; rotation < 6; rotation++) {
+        for (int reflect = 0; reflect < 2; reflect++) {
+            int steps[STEP_CODES];
+            for (int dq = -1; dq <= 1; dq++) {
+                for (int dr = -1; dr <= 1; dr++) {
+                    int q = dq, r = dr, s = -dq - dr;
+                    for (int k = 0; k < rotation; k++) {
+                        int t = q;
+                        q = -r;
+                        r = -s;
+                        s = -t;
+                    }
+                    if (reflect) {
+                        swap(r, s);
+                    }
+                    bool inRange = q >= -1 && q <= 1 && r >= -1 && r <= 1;
+                    steps[encodeStep(dq, dr)] = inRange ? encodeStep(q, r) : encodeStep(dq, dr);
+                }
+            }
+            tables.addElement(steps);
+        }
+    }
+    return tables;
+}
+
+const SymmetryTables& tablesFor(TopologyKind topology) {
+    static const SymmetryTables square = buildSquareTables();
+    static const SymmetryTables hex = buildHexTables();
+    return topology == TOPOLOGY_HEX ? hex : square;
+}
+
+// 一步位移的编码，不是单位步时返回-1
+int stepCode(TopologyKind topology, const GridCell& delta) {
+    if (topology == TOPOLOGY_HEX) {
+        HexCell hex = HexCell::fromCell(delta);
+        if (hex.distanceTo(HexCell()) != 1) {
+            return -1;
+        }
+        return encodeStep(hex.getQ(), hex.getR());
+    }
+    int dr = delta.getRow();
+    int dc = delta.getCol();
+    bool unit = topology == TOPOLOGY_KING ? max(abs(dr), abs(dc)) == 1 : abs(dr) + abs(dc) == 1;
+    return unit ? encodeStep(dr, dc) : -1;
+}
+
+} // namespace
+
+bool PuzzleHash::canonicalize(TopologyKind topology, CellSpan actual, CellSpan relative, vector<uint8_t>& form) {
+    form.clear();
+    size_t length = min(actual.size(), relative.size());
+    if (length < 2) {
+        return true;
+    }
+    form.resize(length - 1);
+    for (size_t i = 1; i < length; i++) {
+        int a = stepCode(topology, actual[i] - actual[i - 1]);
+        int b = stepCode(topology, relative[i] - relative[i - 1]);
+        if (a < 0 || b < 0) {
+            form.clear();
+            return false;
+        }
+        form[i - 1] = static_cast<uint8_t>(a * STEP_CODES + b);
+    }
+
+    // 逐个变换与当前最小者比较，多数情况在前几步就能分出大小
+    const SymmetryTables& tables = tablesFor(topology);
+    int best = 0;
+    for (int g = 1; g < tables.count; g++) {
+        const uint8_t* candidate = tables.pairs[g];
+        const uint8_t* current = tables.pairs[best];
+        for (size_t i = 0; i < form.size(); i++) {
+            if (candidate[form[i]] != current[form[i]]) {
+                if (candidate[form[i]] < current[form[i]]) {
+                    best = g;
+                }
+                break;
+            }
+        }
+    }
+    const uint8_t* permutation = tables.pairs[best];
+    for (size_t i = 0; i < form.size(); i++) {
+        form[i] = permutation[form[i]];
+    }
+    return true;
+}
+
+uint64_t PuzzleHash::hashForm(TopologyKind topology, const vector<uint8_t>& form) {
+    // FNV-1a，再用splitmix64的混合函数打散
+    uint64_t h = 0xCBF29CE484222325ull ^ (static_cast<uint64_t>(topology) << 56);
+    for (size_t i = 0; i < form.size(); i++) {
+        h = (h ^ form[i]) * 0x100000001B3ull;
+    }
+    h ^= form.size();
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return h == INVALID_HASH ? 1 : h;
+}
+
+uint64_t PuzzleHash::hash(TopologyKind topology, CellSpan actual, CellSpan relative) {
+    vector<uint8_t> form;
+    if (!canonicalize(topology, actual, relative, form)) {
+        return INVALID_HASH;
+    }
+    return hashForm(topology, form);
+}
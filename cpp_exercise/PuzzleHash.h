@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "CellSpan.h"
+#include "Topology.h"
+
+// 谜题的规范形式与64位哈希
+// 起点是随机的，只差一次平移、旋转或翻转的两局谜题对玩家来说是同一道题：
+// 把每一步的（参考轨迹位移, 相对轨迹位移）编码成一个字节，在对称群（四方向、八方向为D4，六方向为D6）的
+// 所有变换下取字典序最小的编码序列作为规范形式，再对它求哈希，整体O(n)
+// 两条轨迹的起点位置和合成轨迹的摆放位置不参与哈希
+class PuzzleHash {
+public:
+    // 无法计算哈希（位移不是该拓扑的单位步）时返回的值
+    static const uint64_t INVALID_HASH = 0;
+
+    // 计算规范形式，按两条轨迹中较短的一条的步数；位移不是该拓扑的单位步时返回false
+    static bool canonicalize(TopologyKind topology, CellSpan actual, CellSpan relative, std::vector<uint8_t>& form);
+
+    // 规范形式的哈希，拓扑不同的谜题哈希不同；结果不会等于INVALID_HASH
+    static uint64_t hashForm(TopologyKind topology, const std::vector<uint8_t>& form);
+
+    // 直接计算一局谜题的哈希，失败时返回INVALID_HASH
+    static uint64_t hash(TopologyKind topology, CellSpan actual, CellSpan relative);
+};
@@ -0,0 +1,117 @@
+#pragma once
+#include <cstdint>
+#include <chrono>
+#include <random>
+
+// 轨迹生成使用的伪随机数引擎（xoshiro256**）
+// 每个GameObject持有自己的引擎并显式设置种子：同一种子总是生成同一局谜题，
+// 不同对象之间互不干扰，可以在多个线程中同时生成
+// jump()相当于前进2^128步，用于从同一种子派生互不重叠的随机序列
+class RandomEngine {
+private:
+    uint64_t state[4];
+
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    // splitmix64：把一个64位种子展开成初始状态
+    static uint64_t splitmix64(uint64_t& x) {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+public:
+    // 构造函数
+    explicit RandomEngine(uint64_t seedValue = 0) {
+        seed(seedValue);
+    }
+
+    // 重新设置种子
+    void seed(uint64_t seedValue) {
+        uint64_t x = seedValue;
+        for (int i = 0; i < 4; i++) {
+            state[i] = splitmix64(x);
+        }
+    }
+
+    // 下一个64位随机数
+    uint64_t next() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // [0, bound)内均匀分布的整数，bound必须为正
+    // 用乘法取高位代替取模，只在极少数情况下需要重抽以消除偏差
+    int nextInt(int bound) {
+        uint64_t range = static_cast<uint64_t>(bound);
+        uint32_t x = static_cast<uint32_t>(next() >> 32);
+        uint64_t m = uint64_t(x) * range;
+        uint32_t low = static_cast<uint32_t>(m);
+        if (low < range) {
+            uint32_t threshold = static_cast<uint32_t>(-static_cast<uint32_t>(range)) % static_cast<uint32_t>(range);
+            while (low < threshold) {
+                x = static_cast<uint32_t>(next() >> 32);
+                m = uint64_t(x) * range;
+                low = static_cast<uint32_t>(m);
+            }
+        }
+        return static_cast<int>(m >> 32);
+    }
+
+    // [minValue, maxValue]内均匀分布的整数
+    int nextInRange(int minValue, int maxValue) {
+        return minValue + nextInt(maxValue - minValue + 1);
+    }
+
+    // [0, 1)内均匀分布的浮点数
+    double nextDouble() {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // 前进2^128步，得到一条与当前序列不重叠的新序列
+    void jump() {
+        static const uint64_t JUMP[4] = {
+            0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+            0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull
+        };
+        uint64_t s[4] = {0, 0, 0, 0};
+        for (int i = 0; i < 4; i++) {
+            for (int b = 0; b < 64; b++) {
+                if (JUMP[i] & (uint64_t(1) << b)) {
+                    for (int k = 0; k < 4; k++) {
+                        s[k] ^= state[k];
+                    }
+                }
+                next();
+            }
+        }
+        for (int k = 0; k < 4; k++) {
+            state[k] = s[k];
+        }
+    }
+
+    // 把当前序列交给返回的副本，自身跳到下一条序列，便于依次派生多个独立引擎
+    RandomEngine split() {
+        RandomEngine child = *this;
+        jump();
+        return child;
+    }
+
+    // 没有指定种子时使用的默认种子（系统熵源与时钟混合）
+    static uint64_t seedFromClock() {
+        std::random_device device;
+        uint64_t entropy = (uint64_t(device()) << 32) ^ device();
+        uint64_t ticks = static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        return entropy ^ (ticks * 0x9E3779B97F4A7C15ull);
+    }
+};
@@ -0,0 +1,98 @@
+#include "SeenPuzzleFilter.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+
+namespace {
+
+const char FILTER_MAGIC[4] = {'T', 'P', 'S', 'F'};
+
+// 双重哈希：第i个位置为h1 + i*h2，h2取奇数，各位置互不相同
+size_t bitPosition(uint64_t hash, int i, size_t bits) {
+    uint64_t h2 = ((hash >> 32) | (hash << 32)) | 1;
+    return static_cast<size_t>((hash + i * h2) & (bits - 1));
+}
+
+} // namespace
+
+SeenPuzzleFilter::SeenPuzzleFilter()
+    : current(WORDS, 0), previous(WORDS, 0), currentCount(0) {}
+
+bool SeenPuzzleFilter::test(const vector<uint64_t>& bits, uint64_t hash) {
+    for (int i = 0; i < HASH_COUNT; i++) {
+        size_t bit = bitPosition(hash, i, GENERATION_BITS);
+        if ((bits[bit / 64] & (uint64_t(1) << (bit % 64))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SeenPuzzleFilter::contains(uint64_t hash) const {
+    return test(current, hash) || test(previous, hash);
+}
+
+bool SeenPuzzleFilter::insert(uint64_t hash) {
+    bool rotated = currentCount >= GENERATION_CAPACITY;
+    if (rotated) {
+        // 当前一代已满，丢弃最旧的一代
+        current.swap(previous);
+        fill(current.begin(), current.end(), 0);
+        currentCount = 0;
+    }
+    for (int i = 0; i < HASH_COUNT; i++) {
+        size_t bit = bitPosition(hash, i, GENERATION_BITS);
+        current[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+    currentCount++;
+    return rotated;
+}
+
+void SeenPuzzleFilter::clear() {
+    fill(current.begin(), current.end(), 0);
+    fill(previous.begin(), previous.end(), 0);
+    currentCount = 0;
+}
+
+size_t SeenPuzzleFilter::getMemoryBytes() const {
+    return (current.size() + previous.size()) * sizeof(uint64_t);
+}
+
+bool SeenPuzzleFilter::load(const string& path) {
+    clear();
+    ifstream in(path.c_str(), ios::binary);
+    if (!in) {
+        return false;
+    }
+    FileHeader head;
+    if (!in.read(reinterpret_cast<char*>(&head), sizeof(head)) ||
+        memcmp(head.magic, FILTER_MAGIC, sizeof(FILTER_MAGIC)) != 0 || head.version != VERSION ||
+        head.generationBits != GENERATION_BITS || head.currentCount > GENERATION_CAPACITY) {
+        return false;
+    }
+    if (!in.read(reinterpret_cast<char*>(current.data()), WORDS * sizeof(uint64_t)) ||
+        !in.read(reinterpret_cast<char*>(previous.data()), WORDS * sizeof(uint64_t))) {
+        clear();
+        return false;
+    }
+    currentCount = head.currentCount;
+    return true;
+}
+
+bool SeenPuzzleFilter::save(const string& path) const {
+    ofstream out(path.c_str(), ios::binary | ios::trunc);
+    if (!out) {
+        return false;
+    }
+    FileHeader head;
+    memcpy(head.magic, FILTER_MAGIC, sizeof(FILTER_MAGIC));
+    head.version = VERSION;
+    head.generationBits = static_cast<uint32_t>(GENERATION_BITS);
+    head.currentCount = currentCount;
+    out.write(reinterpret_cast<const char*>(&head), sizeof(head));
+    out.write(reinterpret_cast<const char*>(current.data()), WORDS * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char*>(previous.data()), WORDS * sizeof(uint64_t));
+    return static_cast<bool>(out);
+}
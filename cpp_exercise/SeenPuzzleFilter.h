@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 记录一个玩家做过的谜题（PuzzleHash的规范哈希）的布隆过滤器，查询和插入都是O(1)
+// 内存固定：两代各GENERATION_BITS位，当前一代插入满GENERATION_CAPACITY个后变为上一代、再开新的一代，
+// 所以总是记得最近GENERATION_CAPACITY到2*GENERATION_CAPACITY局，误判率不会随局数增长
+// 查询时两代都要查，两代都装满时误判率约为单代的两倍（约千分之一）；
+// 误判（没做过的题被当作做过）只会让出题多换一次，不会影响正确性
+// 文件布局（本机字节序）：FileHeader，当前一代的位图，上一代的位图
+class SeenPuzzleFilter {
+public:
+    static const size_t GENERATION_BITS = 1 << 16;      // 每一代8KB
+    static const uint32_t GENERATION_CAPACITY = 4096;   // 每个谜题约16位，单代装满时误判率约万分之六
+    static const int HASH_COUNT = 8;
+    static const uint32_t VERSION = 1;
+
+private:
+    struct FileHeader {
+        char magic[4];          // "TPSF"
+        uint32_t version;
+        uint32_t generationBits;
+        uint32_t currentCount;
+    };
+
+    static const size_t WORDS = GENERATION_BITS / 64;
+
+    std::vector<uint64_t> current;   // 当前一代
+    std::vector<uint64_t> previous;  // 上一代
+    uint32_t currentCount;           // 当前一代已插入的数量
+
+    static bool test(const std::vector<uint64_t>& bits, uint64_t hash);
+
+public:
+    // 构造函数（空过滤器）
+    SeenPuzzleFilter();
+
+    // 是否可能见过（可能误判为见过，不会漏判最近插入的）
+    bool contains(uint64_t hash) const;
+
+    // 记录一个哈希，当前一代已满、这次插入开启了新的一代时返回true
+    bool insert(uint64_t hash);
+
+    // 清空
+    void clear();
+
+    // 两代位图占用的字节数
+    size_t getMemoryBytes() const;
+
+    // 从文件读取，文件不存在或格式不符时清空并返回false
+    bool load(const std::string& path);
+
+    // 写入文件，失败时返回false
+    bool save(const std::string& path) const;
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include "RandomEngine.h"
+
+// 在轴对齐的盒子里均匀抽取与center“相距足够远”的格子：
+// 至少有一个坐标轴上与center相差不少于separation格（与原来拒绝采样的条件相同）
+// 满足条件的格子按编号排列，直接把随机编号映射成坐标，不需要重抽
+class SeparatedCellSampler {
+private:
+    // 一个坐标轴：取值范围[lo, hi]，与center相差不到separation的排除区间[bandLo, bandHi]
+    struct Axis {
+        int lo, hi, bandLo, bandHi;
+
+        Axis(int minValue, int maxValue, int center, int separation)
+            : lo(minValue), hi(maxValue), bandLo(center - separation + 1), bandHi(center + separation - 1) {
+            if (bandLo < lo) bandLo = lo;
+            if (bandHi > hi) bandHi = hi;
+            if (separation <= 0 || bandLo > bandHi) {
+                // 排除区间为空
+                bandLo = lo;
+                bandHi = lo - 1;
+            }
+        }
+
+        int size() const { return hi - lo + 1; }
+        int bandSize() const { return bandHi - bandLo + 1; }
+        int outsideSize() const { return size() - bandSize(); }
+
+        // 排除区间之外的第i个坐标
+        int outside(int i) const {
+            int below = bandLo - lo;
+            return i < below ? lo + i : bandHi + 1 + (i - below);
+        }
+    };
+
+    // 两个坐标轴上“不同时落在排除区间内”的格子数量
+    static int complementSize(const Axis& a, const Axis& b) {
+        return a.size() * b.size() - a.bandSize() * b.bandSize();
+    }
+
+    // 把编号k映射成两个坐标轴上的坐标：先是a在排除区间外的整行，再是a在区间内、b在区间外的部分
+    static void mapComplement(const Axis& a, const Axis& b, int k, int& x, int& y) {
+        int first = a.outsideSize() * b.size();
+        if (k < first) {
+            x = a.outside(k / b.size());
+            y = b.lo + k % b.size();
+        } else {
+            k -= first;
+            x = a.bandLo + k / b.outsideSize();
+            y = b.outside(k % b.outsideSize());
+        }
+    }
+
+public:
+    // 二维：在[minCoord, maxCoord]^2中抽取，满足条件的格子不存在时返回false
+    // 棋盘边长不超过BoardConfig的限制，格子总数在int范围内
+    static bool pick(RandomEngine& random, int minCoord, int maxCoord, int centerRow, int centerCol,
+                     int separation, int& row, int& col) {
+        Axis rows(minCoord, maxCoord, centerRow, separation);
+        Axis cols(minCoord, maxCoord, centerCol, separation);
+        int total = complementSize(rows, cols);
+        if (total <= 0) {
+            return false;
+        }
+        mapComplement(rows, cols, random.nextInt(total), row, col);
+        return true;
+    }
+
+    // 三维：在[minCoord, maxCoord]^3中抽取
+    static bool pick(RandomEngine& random, int minCoord, int maxCoord, int centerRow, int centerCol, int centerLayer,
+                     int separation, int& row, int& col, int& layer) {
+        Axis rows(minCoord, maxCoord, centerRow, separation);
+        Axis cols(minCoord, maxCoord, centerCol, separation);
+        Axis layers(minCoord, maxCoord, centerLayer, separation);
+        int plane = cols.size() * layers.size();
+        int first = rows.outsideSize() * plane;
+        int total = first + rows.bandSize() * complementSize(cols, layers);
+        if (total <= 0) {
+            return false;
+        }
+        int k = random.nextInt(total);
+        if (k < first) {
+            row = rows.outside(k / plane);
+            col = cols.lo + (k % plane) / layers.size();
+            layer = layers.lo + k % layers.size();
+        } else {
+            k -= first;
+            int perRow = complementSize(cols, layers);
+            row = rows.bandLo + k / perRow;
+            mapComplement(cols, layers, k % perRow, col, layer);
+        }
+        return true;
+    }
+};
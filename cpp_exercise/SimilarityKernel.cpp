@@ -0,0 +1,221 @@
+#include "SimilarityKernel.h"
+#include <atomic>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SIMILARITY_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang需要为单个函数开启指令集，MSVC可直接使用内建函数
+#if defined(SIMILARITY_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+using namespace std;
+
+namespace {
+
+int bitCount(uint32_t x) {
+    // 不依赖POPCNT指令的位计数
+    x = x - ((x >> 1) & 0x55555555u);
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    x = (x + (x >> 4)) & 0x0F0F0F0Fu;
+    return static_cast<int>((x * 0x01010101u) >> 24);
+}
+
+size_t countPackedScalar(const GridCell* a, const GridCell* b, size_t count) {
+    size_t matches = 0;
+    for (size_t i = 0; i < count; i++) {
+        matches += (a[i] == b[i]);
+    }
+    return matches;
+}
+
+size_t countSplitScalar(const int16_t* rowsA, const int16_t* colsA,
+                        const int16_t* rowsB, const int16_t* colsB, size_t count) {
+    size_t matches = 0;
+    for (size_t i = 0; i < count; i++) {
+        matches += (rowsA[i] == rowsB[i]) & (colsA[i] == colsB[i]);
+    }
+    return matches;
+}
+
+#ifdef SIMILARITY_X86
+
+TARGET_SSE2 size_t countPackedSse2(const GridCell* a, const GridCell* b, size_t count) {
+    // 每次比较4个打包单元格
+    size_t matches = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(va, vb)));
+        matches += bitCount(static_cast<uint32_t>(mask));
+    }
+    return matches + countPackedScalar(a + i, b + i, count - i);
+}
+
+TARGET_SSE2 size_t countSplitSse2(const int16_t* rowsA, const int16_t* colsA,
+                                  const int16_t* rowsB, const int16_t* colsB, size_t count) {
+    // 每次比较8个单元格，行列比较结果按位与
+    size_t matches = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i ra = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowsA + i));
+        __m128i rb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rowsB + i));
+        __m128i ca = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colsA + i));
+        __m128i cb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colsB + i));
+        __m128i eq = _mm_and_si128(_mm_cmpeq_epi16(ra, rb), _mm_cmpeq_epi16(ca, cb));
+        // 每个16位通道在字节掩码中占2位
+        matches += bitCount(static_cast<uint32_t>(_mm_movemask_epi8(eq))) / 2;
+    }
+    return matches + countSplitScalar(rowsA + i, colsA + i, rowsB + i, colsB + i, count - i);
+}
+
+TARGET_AVX2 size_t countPackedAvx2(const GridCell* a, const GridCell* b, size_t count) {
+    // 每次比较8个打包单元格
+    size_t matches = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(va, vb)));
+        matches += bitCount(static_cast<uint32_t>(mask));
+    }
+    return matches + countPackedScalar(a + i, b + i, count - i);
+}
+
+TARGET_AVX2 size_t countSplitAvx2(const int16_t* rowsA, const int16_t* colsA,
+                                  const int16_t* rowsB, const int16_t* colsB, size_t count) {
+    // 每次比较16个单元格
+    size_t matches = 0;
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i ra = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowsA + i));
+        __m256i rb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowsB + i));
+        __m256i ca = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(colsA + i));
+        __m256i cb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(colsB + i));
+        __m256i eq = _mm256_and_si256(_mm256_cmpeq_epi16(ra, rb), _mm256_cmpeq_epi16(ca, cb));
+        matches += bitCount(static_cast<uint32_t>(_mm256_movemask_epi8(eq))) / 2;
+    }
+    return matches + countSplitScalar(rowsA + i, colsA + i, rowsB + i, colsB + i, count - i);
+}
+
+bool cpuHasSse2() {
+#if defined(_M_X64) || defined(__x86_64__)
+    return true; // x86-64必定支持SSE2
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false; // 操作系统未保存YMM寄存器
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // SIMILARITY_X86
+
+SimilarityKernel::Kind detectBestKernel() {
+    if (SimilarityKernel::isSupported(SimilarityKernel::AVX2)) {
+        return SimilarityKernel::AVX2;
+    }
+    if (SimilarityKernel::isSupported(SimilarityKernel::SSE2)) {
+        return SimilarityKernel::SSE2;
+    }
+    return SimilarityKernel::SCALAR;
+}
+
+std::atomic<int>& activeKernel() {
+    // 首次使用时探测CPU
+    static std::atomic<int> kind(static_cast<int>(detectBestKernel()));
+    return kind;
+}
+
+} // namespace
+
+size_t SimilarityKernel::countMatches(const GridCell* a, const GridCell* b, size_t count) {
+    switch (getActive()) {
+#ifdef SIMILARITY_X86
+        case AVX2: return countPackedAvx2(a, b, count);
+        case SSE2: return countPackedSse2(a, b, count);
+#endif
+        default: return countPackedScalar(a, b, count);
+    }
+}
+
+size_t SimilarityKernel::countMatches(const int16_t* rowsA, const int16_t* colsA,
+                                      const int16_t* rowsB, const int16_t* colsB, size_t count) {
+    switch (getActive()) {
+#ifdef SIMILARITY_X86
+        case AVX2: return countSplitAvx2(rowsA, colsA, rowsB, colsB, count);
+        case SSE2: return countSplitSse2(rowsA, colsA, rowsB, colsB, count);
+#endif
+        default: return countSplitScalar(rowsA, colsA, rowsB, colsB, count);
+    }
+}
+
+SimilarityKernel::Kind SimilarityKernel::getActive() {
+    return static_cast<Kind>(activeKernel().load(std::memory_order_relaxed));
+}
+
+bool SimilarityKernel::setActive(Kind kind) {
+    if (!isSupported(kind)) {
+        return false;
+    }
+    activeKernel().store(static_cast<int>(kind), std::memory_order_relaxed);
+    return true;
+}
+
+bool SimilarityKernel::isSupported(Kind kind) {
+    switch (kind) {
+        case SCALAR:
+            return true;
+#ifdef SIMILARITY_X86
+        case SSE2: {
+            static const bool supported = cpuHasSse2();
+            return supported;
+        }
+        case AVX2: {
+            static const bool supported = cpuHasAvx2();
+            return supported;
+        }
+#endif
+        default:
+            return false;
+    }
+}
+
+const char* SimilarityKernel::getName(Kind kind) {
+    switch (kind) {
+        case AVX2: return "avx2";
+        case SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "GridCell.h"
+
+// 轨迹相似度的内层比较核：统计两组坐标中逐项相等的个数
+// 支持SSE2/AVX2向量化实现，运行时根据CPU选择，不支持时使用标量实现
+class SimilarityKernel {
+public:
+    enum Kind {
+        SCALAR = 0,
+        SSE2 = 1,
+        AVX2 = 2
+    };
+
+    // 打包单元格（AoS）逐项比较
+    static size_t countMatches(const GridCell* a, const GridCell* b, size_t count);
+
+    // 行列分离存储（SoA）逐项比较，行列都相等才计数
+    static size_t countMatches(const int16_t* rowsA, const int16_t* colsA,
+                               const int16_t* rowsB, const int16_t* colsB, size_t count);
+
+    // 当前使用的实现
+    static Kind getActive();
+
+    // 指定实现（用于测试和基准），CPU不支持时返回false且不做修改
+    static bool setActive(Kind kind);
+
+    // 判断CPU是否支持某种实现
+    static bool isSupported(Kind kind);
+
+    // 实现名称
+    static const char* getName(Kind kind);
+};
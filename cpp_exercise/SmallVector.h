@@ -0,0 +1,166 @@
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+// 小缓冲优化的动态数组：前N个元素存放在对象内部，超过N个才分配堆内存
+// 只用于GridCell这类可平凡复制的类型，扩容时直接按字节复制
+template <typename T, size_t N>
+class SmallVector {
+    static_assert(std::is_trivially_copyable<T>::value, "SmallVector只支持可平凡复制的类型");
+    static_assert(N > 0, "内联容量必须大于0");
+
+private:
+    T* ptr;                  // 指向inlineBuffer或堆内存
+    size_t count;            // 元素数量
+    size_t cap;              // 当前容量
+    alignas(T) unsigned char inlineBuffer[N * sizeof(T)];
+
+    T* inlineData() { return reinterpret_cast<T*>(inlineBuffer); }
+    bool isInline() const { return ptr == reinterpret_cast<const T*>(inlineBuffer); }
+
+    void grow(size_t minCapacity) {
+        size_t newCapacity = cap * 2;
+        if (newCapacity < minCapacity) {
+            newCapacity = minCapacity;
+        }
+        T* newData = static_cast<T*>(std::malloc(newCapacity * sizeof(T)));
+        if (!newData) {
+            throw std::bad_alloc();
+        }
+        std::memcpy(static_cast<void*>(newData), ptr, count * sizeof(T));
+        if (!isInline()) {
+            std::free(ptr);
+        }
+        ptr = newData;
+        cap = newCapacity;
+    }
+
+    void copyFrom(const SmallVector& other) {
+        if (other.count > cap) {
+            grow(other.count);
+        }
+        std::memcpy(static_cast<void*>(ptr), other.ptr, other.count * sizeof(T));
+        count = other.count;
+    }
+
+    void moveFrom(SmallVector& other) {
+        if (other.isInline()) {
+            std::memcpy(static_cast<void*>(ptr), other.ptr, other.count * sizeof(T));
+            count = other.count;
+        } else {
+            // 直接接管对方的堆内存
+            ptr = other.ptr;
+            count = other.count;
+            cap = other.cap;
+            other.ptr = other.inlineData();
+            other.cap = N;
+        }
+        other.count = 0;
+    }
+
+    void releaseHeap() {
+        if (!isInline()) {
+            std::free(ptr);
+            ptr = inlineData();
+            cap = N;
+        }
+    }
+
+public:
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    SmallVector() : ptr(inlineData()), count(0), cap(N) {}
+
+    SmallVector(const SmallVector& other) : ptr(inlineData()), count(0), cap(N) {
+        copyFrom(other);
+    }
+
+    SmallVector(SmallVector&& other) noexcept : ptr(inlineData()), count(0), cap(N) {
+        moveFrom(other);
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            count = 0;
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this != &other) {
+            releaseHeap();
+            count = 0;
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector() {
+        releaseHeap();
+    }
+
+    // 容量与大小
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t capacity() const { return cap; }
+    static constexpr size_t inlineCapacity() { return N; }
+    // 是否已经溢出到堆内存
+    bool isOnHeap() const { return !isInline(); }
+
+    void reserve(size_t newCapacity) {
+        if (newCapacity > cap) {
+            grow(newCapacity);
+        }
+    }
+
+    // 元素访问（不做边界检查）
+    T* data() { return ptr; }
+    const T* data() const { return ptr; }
+    T& operator[](size_t index) { return ptr[index]; }
+    const T& operator[](size_t index) const { return ptr[index]; }
+    T& front() { return ptr[0]; }
+    const T& front() const { return ptr[0]; }
+    T& back() { return ptr[count - 1]; }
+    const T& back() const { return ptr[count - 1]; }
+
+    iterator begin() { return ptr; }
+    iterator end() { return ptr + count; }
+    const_iterator begin() const { return ptr; }
+    const_iterator end() const { return ptr + count; }
+
+    // 修改
+    void push_back(const T& value) {
+        if (count == cap) {
+            T copy = value; // value可能指向自身缓冲区
+            grow(count + 1);
+            ptr[count++] = copy;
+            return;
+        }
+        ptr[count++] = value;
+    }
+
+    void pop_back() { count--; }
+
+    // 清空元素，保留已分配的容量
+    void clear() { count = 0; }
+
+    bool operator==(const SmallVector& other) const {
+        if (count != other.count) {
+            return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (!(ptr[i] == other.ptr[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator!=(const SmallVector& other) const { return !(*this == other); }
+};
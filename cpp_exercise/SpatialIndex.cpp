@@ -0,0 +1,172 @@
+#include "SpatialIndex.h"
+#include <algorithm>
+#include <stdexcept>
+using namespace std;
+
+namespace {
+
+// 坐标加上偏移后作为无符号数参与编码，保证Z序与坐标大小一致
+const int COORD_BIAS = 32768;
+
+// 把16位数的各位分散到偶数位
+uint32_t spreadBits(uint32_t x) {
+    x &= 0x0000FFFFu;
+    x = (x | (x << 8)) & 0x00FF00FFu;
+    x = (x | (x << 4)) & 0x0F0F0F0Fu;
+    x = (x | (x << 2)) & 0x33333333u;
+    x = (x | (x << 1)) & 0x55555555u;
+    return x;
+}
+
+// spreadBits的逆运算
+uint32_t compactBits(uint32_t x) {
+    x &= 0x55555555u;
+    x = (x | (x >> 1)) & 0x33333333u;
+    x = (x | (x >> 2)) & 0x0F0F0F0Fu;
+    x = (x | (x >> 4)) & 0x00FF00FFu;
+    x = (x | (x >> 8)) & 0x0000FFFFu;
+    return x;
+}
+
+} // namespace
+
+SpatialIndex::SpatialIndex() : built(true) {
+    // 空索引视为已建立
+}
+
+uint32_t SpatialIndex::encodeMorton(const GridCell& cell) {
+    uint32_t row = static_cast<uint32_t>(cell.getRow() + COORD_BIAS);
+    uint32_t col = static_cast<uint32_t>(cell.getCol() + COORD_BIAS);
+    return (spreadBits(row) << 1) | spreadBits(col);
+}
+
+GridCell SpatialIndex::decodeMorton(uint32_t key) {
+    int row = static_cast<int>(compactBits(key >> 1)) - COORD_BIAS;
+    int col = static_cast<int>(compactBits(key)) - COORD_BIAS;
+    return GridCell(row, col);
+}
+
+void SpatialIndex::addTrajectory(uint32_t trajectoryId, const Trajectory& trajectory) {
+    CellSpan cells = trajectory.getSpan();
+    keys.reserve(keys.size() + cells.size());
+    postings.reserve(postings.size() + cells.size());
+    for (size_t i = 0; i < cells.size(); i++) {
+        keys.push_back(encodeMorton(cells[i]));
+        postings.push_back(Posting{trajectoryId, static_cast<uint32_t>(i)});
+    }
+    built = false;
+}
+
+void SpatialIndex::build() {
+    if (built) {
+        return;
+    }
+    // 按(键, 轨迹编号, 步数)排序，再拆回两个连续数组
+    struct Entry {
+        uint32_t key;
+        Posting posting;
+    };
+    vector<Entry> entries(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        entries[i].key = keys[i];
+        entries[i].posting = postings[i];
+    }
+    sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        if (a.key != b.key) return a.key < b.key;
+        if (a.posting.trajectoryId != b.posting.trajectoryId) return a.posting.trajectoryId < b.posting.trajectoryId;
+        return a.posting.step < b.posting.step;
+    });
+    for (size_t i = 0; i < entries.size(); i++) {
+        keys[i] = entries[i].key;
+        postings[i] = entries[i].posting;
+    }
+    built = true;
+}
+
+size_t SpatialIndex::size() const {
+    return keys.size();
+}
+
+vector<SpatialIndex::Posting> SpatialIndex::queryCell(const GridCell& cell) const {
+    if (!built) {
+        throw std::logic_error("SpatialIndex::build must be called before querying");
+    }
+    uint32_t key = encodeMorton(cell);
+    auto range = equal_range(keys.begin(), keys.end(), key);
+    size_t first = range.first - keys.begin();
+    size_t last = range.second - keys.begin();
+    return vector<Posting>(postings.begin() + first, postings.begin() + last);
+}
+
+uint32_t SpatialIndex::nextInRegion(uint32_t zval, uint32_t zmin, uint32_t zmax) {
+    // Tropf-Herzog BIGMIN：从高位到低位比较zval与区间边界，逐步收缩区间
+    uint32_t bigmin = zmax;
+    for (int bit = 31; bit >= 0; bit--) {
+        uint32_t mask = uint32_t(1) << bit;
+        // 与当前位同一维度、且更低的所有位
+        uint32_t lower = (0x55555555u << (bit & 1)) & (mask - 1);
+        bool v = (zval & mask) != 0;
+        bool lo = (zmin & mask) != 0;
+        bool hi = (zmax & mask) != 0;
+        if (!v && !lo && hi) {
+            // 区间被这一位切成两半：候选为上半区的最小值，继续在下半区查找
+            bigmin = (zmin & ~lower) | mask;
+            zmax = (zmax & ~mask) | lower;
+        } else if (!v && lo && hi) {
+            return zmin;
+        } else if (v && !lo && !hi) {
+            return bigmin;
+        } else if (v && !lo && hi) {
+            zmin = (zmin & ~lower) | mask;
+        }
+        // 其余情况（三者相同）继续比较下一位
+    }
+    return bigmin;
+}
+
+vector<SpatialIndex::Posting> SpatialIndex::queryRegion(const GridCell& minCell, const GridCell& maxCell) const {
+    if (!built) {
+        throw std::logic_error("SpatialIndex::build must be called before querying");
+    }
+    vector<Posting> result;
+    int minRow = min(minCell.getRow(), maxCell.getRow());
+    int maxRow = max(minCell.getRow(), maxCell.getRow());
+    int minCol = min(minCell.getCol(), maxCell.getCol());
+    int maxCol = max(minCell.getCol(), maxCell.getCol());
+    uint32_t zmin = encodeMorton(GridCell(minRow, minCol));
+    uint32_t zmax = encodeMorton(GridCell(maxRow, maxCol));
+
+    auto it = lower_bound(keys.begin(), keys.end(), zmin);
+    while (it != keys.end() && *it <= zmax) {
+        GridCell cell = decodeMorton(*it);
+        if (cell.getRow() >= minRow && cell.getRow() <= maxRow &&
+            cell.getCol() >= minCol && cell.getCol() <= maxCol) {
+            result.push_back(postings[it - keys.begin()]);
+            ++it;
+        } else {
+            // 跳到区间内下一个落在矩形中的键
+            uint32_t next = nextInRegion(*it, zmin, zmax);
+            if (next <= *it) {
+                break;
+            }
+            it = lower_bound(it, keys.end(), next);
+        }
+    }
+    return result;
+}
+
+vector<uint32_t> SpatialIndex::queryTrajectories(const GridCell& minCell, const GridCell& maxCell) const {
+    vector<uint32_t> ids;
+    for (const Posting& posting : queryRegion(minCell, maxCell)) {
+        ids.push_back(posting.trajectoryId);
+    }
+    sort(ids.begin(), ids.end());
+    ids.erase(unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+void SpatialIndex::clear() {
+    keys.clear();
+    postings.clear();
+    built = true;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "GridCell.h"
+#include "Trajectory.h"
+
+// 历史轨迹的空间索引，键为单元格坐标的Z序（Morton）编码
+// 所有记录按键排序后连续存放，单元格查询是二分查找，矩形查询按Z序区间扫描并跳过区域外的部分
+class SpatialIndex {
+public:
+    // 一条记录：第trajectoryId条轨迹的第step个单元格
+    struct Posting {
+        uint32_t trajectoryId;
+        uint32_t step;
+    };
+
+private:
+    std::vector<uint32_t> keys;      // 排序后的Morton键，与postings一一对应
+    std::vector<Posting> postings;   // 与keys同序的记录
+    bool built;                      // 是否已排序
+
+    // 在[zmin, zmax]区间内、大于zval的下一个位于矩形中的键（BIGMIN）
+    static uint32_t nextInRegion(uint32_t zval, uint32_t zmin, uint32_t zmax);
+
+public:
+    // 构造函数
+    SpatialIndex();
+
+    // 单元格坐标与Morton键互相转换（行占奇数位，列占偶数位）
+    static uint32_t encodeMorton(const GridCell& cell);
+    static GridCell decodeMorton(uint32_t key);
+
+    // 加入一条轨迹的所有单元格，加入后需要调用build
+    void addTrajectory(uint32_t trajectoryId, const Trajectory& trajectory);
+
+    // 排序建立索引
+    void build();
+
+    // 记录总数
+    size_t size() const;
+
+    // 经过某个单元格的所有记录
+    std::vector<Posting> queryCell(const GridCell& cell) const;
+
+    // 落在矩形区域内（含边界）的所有记录
+    std::vector<Posting> queryRegion(const GridCell& minCell, const GridCell& maxCell) const;
+
+    // 经过矩形区域的轨迹编号（升序、去重）
+    std::vector<uint32_t> queryTrajectories(const GridCell& minCell, const GridCell& maxCell) const;
+
+    // 清空索引
+    void clear();
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+// 单生产者单消费者的无锁环形队列
+// 只允许一个线程调用tryPush、另一个线程调用tryPop；两端各自只写自己的下标，
+// 通过acquire/release顺序保证读到的元素已经完整写入
+// 下标单调递增、按Capacity取模，Capacity个槽位都可以使用
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "容量必须是2的幂");
+
+private:
+    T slots[Capacity];
+    alignas(64) std::atomic<size_t> head; // 下一个要取出的位置，只由消费者写
+    alignas(64) std::atomic<size_t> tail; // 下一个要写入的位置，只由生产者写
+
+public:
+    // 构造函数
+    SpscQueue() : head(0), tail(0) {}
+
+    // 生产者：放入一个元素，队列已满时返回false
+    bool tryPush(const T& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        slots[t & (Capacity - 1)] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者：取出一个元素，队列为空时返回false
+    bool tryPop(T& value) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (tail.load(std::memory_order_acquire) == h) {
+            return false;
+        }
+        value = slots[h & (Capacity - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 当前元素数量（另一端同时操作时只是近似值）
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    bool full() const {
+        return size() == Capacity;
+    }
+
+    // 清空队列，只能在两端都没有其他线程访问时调用
+    void clear() {
+        head.store(tail.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+};
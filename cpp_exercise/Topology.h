@@ -0,0 +1,88 @@
+#pragma once
+#include "GridCell.h"
+#include "Directions.h"
+
+// 移动拓扑：编译期给出方向表和相反方向表
+// 生成器按拓扑实例化，每一步不再根据布尔标志分支
+
+// 运行时选择拓扑时使用的编号
+enum TopologyKind {
+    TOPOLOGY_SQUARE = 0, // 四方向（简单模式）
+    TOPOLOGY_HEX = 1,    // 六方向（复杂模式）
+    TOPOLOGY_KING = 2    // 八方向（含对角线）
+};
+
+// 四方向：上、右、左、下
+struct SquareTopology {
+    static constexpr TopologyKind KIND = TOPOLOGY_SQUARE;
+    static constexpr int DIRECTION_COUNT = 4;
+    static constexpr GridCell DIRECTIONS[DIRECTION_COUNT] = {
+        four_directions[0], four_directions[1], four_directions[2], four_directions[3]
+    };
+    static constexpr int OPPOSITE[DIRECTION_COUNT] = {3, 2, 1, 0};
+    // 环绕一个格子的一圈格子（按角度顺序，相邻两项之间可以一步到达）
+    static constexpr int RING_SIZE = 8;
+    static constexpr GridCell RING[RING_SIZE] = {
+        GridCell(-1, 0), GridCell(-1, 1), GridCell(0, 1), GridCell(1, 1),
+        GridCell(1, 0), GridCell(1, -1), GridCell(0, -1), GridCell(-1, -1)
+    };
+};
+
+// 六方向：上、左上、左下、下、右下、右上
+struct HexTopology {
+    static constexpr TopologyKind KIND = TOPOLOGY_HEX;
+    static constexpr int DIRECTION_COUNT = 6;
+    static constexpr GridCell DIRECTIONS[DIRECTION_COUNT] = {
+        hex_directions[0], hex_directions[1], hex_directions[2],
+        hex_directions[3], hex_directions[4], hex_directions[5]
+    };
+    static constexpr int OPPOSITE[DIRECTION_COUNT] = {3, 4, 5, 0, 1, 2};
+    // 六个相邻格子按下标顺序恰好首尾相接
+    static constexpr int RING_SIZE = 6;
+    static constexpr GridCell RING[RING_SIZE] = {
+        hex_directions[0], hex_directions[1], hex_directions[2],
+        hex_directions[3], hex_directions[4], hex_directions[5]
+    };
+};
+
+// 八方向：前四个与四方向相同，之后依次为左上、右上、左下、右下
+struct KingTopology {
+    static constexpr TopologyKind KIND = TOPOLOGY_KING;
+    static constexpr int DIRECTION_COUNT = 8;
+    static constexpr GridCell DIRECTIONS[DIRECTION_COUNT] = {
+        four_directions[0], four_directions[1], four_directions[2], four_directions[3],
+        GridCell(-1, -1), GridCell(-1, 1), GridCell(1, -1), GridCell(1, 1)
+    };
+    static constexpr int OPPOSITE[DIRECTION_COUNT] = {3, 2, 1, 0, 7, 6, 5, 4};
+    static constexpr int RING_SIZE = 8;
+    static constexpr GridCell RING[RING_SIZE] = {
+        GridCell(-1, 0), GridCell(-1, 1), GridCell(0, 1), GridCell(1, 1),
+        GridCell(1, 0), GridCell(1, -1), GridCell(0, -1), GridCell(-1, -1)
+    };
+};
+
+// 根据运行时编号调用对应拓扑的实例，visitor接收一个拓扑类型的对象
+template <typename Visitor>
+auto visitTopology(TopologyKind kind, Visitor&& visitor) -> decltype(visitor(SquareTopology())) {
+    switch (kind) {
+        case TOPOLOGY_HEX:
+            return visitor(HexTopology());
+        case TOPOLOGY_KING:
+            return visitor(KingTopology());
+        default:
+            return visitor(SquareTopology());
+    }
+}
+
+// 运行时查询方向数量和方向表
+inline int getDirectionCount(TopologyKind kind) {
+    return visitTopology(kind, [](auto topology) { return decltype(topology)::DIRECTION_COUNT; });
+}
+
+inline const GridCell* getDirections(TopologyKind kind) {
+    return visitTopology(kind, [](auto topology) -> const GridCell* { return decltype(topology)::DIRECTIONS; });
+}
+
+inline const int* getOppositeDirections(TopologyKind kind) {
+    return visitTopology(kind, [](auto topology) -> const int* { return decltype(topology)::OPPOSITE; });
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "GridCell3.h"
+
+// 三维移动拓扑，用法与Topology.h中的二维拓扑相同
+
+// 运行时选择三维拓扑时使用的编号
+enum Topology3Kind {
+    TOPOLOGY3_FACE = 0, // 六邻域（沿坐标轴）
+    TOPOLOGY3_FULL = 1  // 二十六邻域（含棱、角对角线）
+};
+
+// 六邻域：前四个与二维四方向一致（上、右、左、下），之后为上一层、下一层
+struct FaceTopology3 {
+    static constexpr Topology3Kind KIND = TOPOLOGY3_FACE;
+    static constexpr int DIRECTION_COUNT = 6;
+    static constexpr GridCell3 DIRECTIONS[DIRECTION_COUNT] = {
+        GridCell3(-1, 0, 0), GridCell3(0, 1, 0), GridCell3(0, -1, 0),
+        GridCell3(1, 0, 0), GridCell3(0, 0, 1), GridCell3(0, 0, -1)
+    };
+    static constexpr int OPPOSITE[DIRECTION_COUNT] = {3, 2, 1, 0, 5, 4};
+};
+
+// 二十六邻域：第k个方向的偏移满足k' = (dr+1)*9 + (dc+1)*3 + (dl+1)，
+// 其中k' = k < 13 ? k : k + 1（跳过原点），因此相反方向为25-k
+constexpr GridCell3 fullNeighborOffset(int k) {
+    return GridCell3((k < 13 ? k : k + 1) / 9 - 1,
+                     (k < 13 ? k : k + 1) / 3 % 3 - 1,
+                     (k < 13 ? k : k + 1) % 3 - 1);
+}
+
+struct FullTopology3 {
+    static constexpr Topology3Kind KIND = TOPOLOGY3_FULL;
+    static constexpr int DIRECTION_COUNT = 26;
+    static constexpr GridCell3 DIRECTIONS[DIRECTION_COUNT] = {
+        fullNeighborOffset(0), fullNeighborOffset(1), fullNeighborOffset(2), fullNeighborOffset(3), fullNeighborOffset(4),
+        fullNeighborOffset(5), fullNeighborOffset(6), fullNeighborOffset(7), fullNeighborOffset(8), fullNeighborOffset(9),
+        fullNeighborOffset(10), fullNeighborOffset(11), fullNeighborOffset(12), fullNeighborOffset(13), fullNeighborOffset(14),
+        fullNeighborOffset(15), fullNeighborOffset(16), fullNeighborOffset(17), fullNeighborOffset(18), fullNeighborOffset(19),
+        fullNeighborOffset(20), fullNeighborOffset(21), fullNeighborOffset(22), fullNeighborOffset(23), fullNeighborOffset(24),
+        fullNeighborOffset(25)
+    };
+    static constexpr int OPPOSITE[DIRECTION_COUNT] = {
+        25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13,
+        12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0
+    };
+};
+static_assert(FullTopology3::DIRECTIONS[0] == GridCell3(-1, -1, -1) &&
+              FullTopology3::DIRECTIONS[12] == GridCell3(0, 0, -1) &&
+              FullTopology3::DIRECTIONS[13] == GridCell3(0, 0, 1) &&
+              FullTopology3::DIRECTIONS[25] == GridCell3(1, 1, 1),
+              "二十六邻域方向表顺序错误");
+
+// 根据运行时编号调用对应拓扑的实例
+template <typename Visitor>
+auto visitTopology3(Topology3Kind kind, Visitor&& visitor) -> decltype(visitor(FaceTopology3())) {
+    switch (kind) {
+        case TOPOLOGY3_FULL:
+            return visitor(FullTopology3());
+        default:
+            return visitor(FaceTopology3());
+    }
+}
@@ -1,27 +1,93 @@
 #include "Trajectory.h"
+#include "SimilarityKernel.h"
 #include<algorithm>
 #include <stdexcept>
+#include <cstdio>
 using namespace std;
 //Trajectory内存储着一堆GridCell，表示一个对象的移动轨迹
-Trajectory::Trajectory() {
+Trajectory::Trajectory() : occupancyEnabled(false) {
     // 构造函数初始化空轨迹
     // currentCell默认为(0,0)
+    resetOccupancy();
+}
+
+int Trajectory::occupancyIndex(const GridCell& cell) {
+    // 把棋盘坐标映射到位图下标，超出范围返回-1
+    int row = cell.getRow() - OCCUPANCY_MIN_COORD;
+    int col = cell.getCol() - OCCUPANCY_MIN_COORD;
+    if (row < 0 || row >= OCCUPANCY_SIDE || col < 0 || col >= OCCUPANCY_SIDE) {
+        return -1;
+    }
+    return row * OCCUPANCY_SIDE + col;
+}
+
+void Trajectory::markOccupied(const GridCell& cell) {
+    int index = occupancyIndex(cell);
+    if (index < 0) {
+        sparseOccupancy.insert(cell);
+        return;
+    }
+    uint64_t bit = uint64_t(1) << (index & 63);
+    if (occupancy[index >> 6] & bit) {
+        occupancyDuplicates++;
+    }
+    occupancy[index >> 6] |= bit;
+}
+
+void Trajectory::unmarkOccupied(const GridCell& cell) {
+    // cell已经从cells中移除
+    int index = occupancyIndex(cell);
+    if (index < 0) {
+        sparseOccupancy.erase(cell);
+        return;
+    }
+    // 存在重复单元格时，只有轨迹中不再包含该格才清除对应位
+    if (occupancyDuplicates > 0 && find(cells.begin(), cells.end(), cell) != cells.end()) {
+        occupancyDuplicates--;
+        return;
+    }
+    occupancy[index >> 6] &= ~(uint64_t(1) << (index & 63));
+}
+
+void Trajectory::resetOccupancy() {
+    fill(occupancy, occupancy + OCCUPANCY_WORDS, 0);
+    occupancyDuplicates = 0;
+    sparseOccupancy.clear();
 }
 
 void Trajectory::addCell(const GridCell& cell) {
     // 向轨迹中添加一个网格单元
     cells.push_back(cell);
+    if (occupancyEnabled) {
+        markOccupied(cell);
+    }
     // 同时更新当前位置
     setCurrentCell(cell);
 }
 
-const std::vector<GridCell>& Trajectory::getCells() const {
-    // 返回包含所有网格单元的向量
+void Trajectory::pop_back() {
+    // 移除最后一个网格单元（回溯时使用）
+    if (cells.empty()) {
+        return;
+    }
+    GridCell removed = cells.back();
+    cells.pop_back();
+    if (occupancyEnabled) {
+        unmarkOccupied(removed);
+    }
+    // 当前位置回退到新的末尾
+    if (!cells.empty()) {
+        setCurrentCell(cells.back());
+    }
+}
+
+const Trajectory::CellStorage& Trajectory::getCells() const {
+    // 返回存储所有网格单元的容器
     return cells;
 }
 
-std::vector<GridCell>& Trajectory::getCells() {
-    // 返回包含所有网格单元的向量（非const版本）
+Trajectory::CellStorage& Trajectory::getCells() {
+    // 返回存储所有网格单元的容器（非const版本）
     return cells;
 }
 
@@ -38,6 +104,32 @@ GridCell Trajectory::getCell(size_t index) const {
     return cells[index];
 }
 
+bool Trajectory::contains(const GridCell& cell) const {
+    // 判断单元格是否已在轨迹中
+    if (occupancyEnabled) {
+        int index = occupancyIndex(cell);
+        if (index >= 0) {
+            return (occupancy[index >> 6] >> (index & 63)) & 1;
+        }
+        return sparseOccupancy.contains(cell);
+    }
+    return find(cells.begin(), cells.end(), cell) != cells.end();
+}
+
+void Trajectory::enableOccupancy(bool enable) {
+    occupancyEnabled = enable;
+    resetOccupancy();
+    if (enable) {
+        for (const GridCell& cell : cells) {
+            markOccupied(cell);
+        }
+    }
+}
+
+bool Trajectory::isOccupancyEnabled() const {
+    return occupancyEnabled;
+}
+
 const GridCell& Trajectory::getCurrentCell() const {
     // 返回当前位置
     return currentCell;
@@ -52,25 +144,23 @@ double Trajectory::calculateSimilarity(const Trajectory& other) const {
      // 计算两条轨迹的相似度
     // 例如，从头开始连续重合的单元格比例
     // 返回值范围：0.0（完全不同）到1.0（完全相同）用于评分
-    double c;
-    int size=min(cells.size(),other.cells.size())-1;
-    if(size){
-    double a=0;
-    for(int i=1;i<=size;i++){
-        if(cells[i]==other.cells[i]){
-            a+=1;
-        }
-    }
-    c= a/size;}
-    else{
+    // 跳过起点，逐项比较交给向量化的比较核
+    size_t length=min(cells.size(),other.cells.size());
+    if(length<2){
         printf("轨迹出错了！");
+        return 0.0;
     }
-    return c;
+    size_t size=length-1;
+    size_t a=SimilarityKernel::countMatches(cells.data()+1,other.cells.data()+1,size);
+    return static_cast<double>(a)/size;
 }
 
 void Trajectory::clear() {
     // 清空轨迹
     cells.clear();
+    if (occupancyEnabled) {
+        resetOccupancy();
+    }
     // 重置当前位置为默认值
     //currentCell = GridCell(0, 0);
 } 
\ No newline at end of file
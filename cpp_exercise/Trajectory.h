@@ -1,40 +1,97 @@
 #pragma once
 #include <vector>
+#include <cstddef>
+#include <cstdint>
 #include "GridCell.h"
+#include "SmallVector.h"
+#include "CellSpan.h"
+#include "CellHashSet.h"
+
+// 轨迹单元格的存储方式，编译时选择：
+// TRAJECTORY_INLINE_CELLS为N（N>0）时前N个单元格内联存放，超过才分配堆内存；
+// 定义为0时退回std::vector
+#ifndef TRAJECTORY_INLINE_CELLS
+#define TRAJECTORY_INLINE_CELLS 24
+#endif
 
 class Trajectory {
+public:
+#if TRAJECTORY_INLINE_CELLS > 0
+    typedef SmallVector<GridCell, TRAJECTORY_INLINE_CELLS> CellStorage;
+#else
+    typedef std::vector<GridCell> CellStorage;
+#endif
+
+    // 占用位图覆盖的坐标范围（默认棋盘的范围），范围之外的单元格记录在哈希集合中
+    static const int OCCUPANCY_MIN_COORD = -15;
+    static const int OCCUPANCY_MAX_COORD = 15;
+
 private:
-    std::vector<GridCell> cells;  // 存储轨迹中的所有网格单元
+    static const int OCCUPANCY_SIDE = OCCUPANCY_MAX_COORD - OCCUPANCY_MIN_COORD + 1;
+    static const int OCCUPANCY_WORDS = (OCCUPANCY_SIDE * OCCUPANCY_SIDE + 63) / 64;
+
+    CellStorage cells;            // 存储轨迹中的所有网格单元
     GridCell currentCell;        // 当前位置
 
+    // 占用位图：每个棋盘格占1位，用于O(1)判断某格是否已在轨迹上
+    uint64_t occupancy[OCCUPANCY_WORDS];
+    bool occupancyEnabled;
+    size_t occupancyDuplicates;  // 重复加入的单元格数量（出现时pop_back需要额外确认）
+    CellHashSet sparseOccupancy; // 位图范围之外的单元格（大棋盘），内存与轨迹长度成正比
+
+    // 计算单元格在位图中的位置，超出范围返回-1
+    static int occupancyIndex(const GridCell& cell);
+    void markOccupied(const GridCell& cell);
+    void unmarkOccupied(const GridCell& cell);
+    void resetOccupancy();
+
 public:
     // 构造函数
     Trajectory();
-    
+
     // 添加一个网格单元到轨迹
     void addCell(const GridCell& cell);
-    
+
+    // 移除最后一个网格单元，并把当前位置回退到新的末尾
+    void pop_back();
+
     // 获取轨迹中所有网格单元
-    const std::vector<GridCell>& getCells() const;
-    
+    const CellStorage& getCells() const;
+
     // 获取轨迹中所有网格单元（非const版本，允许修改）
-    std::vector<GridCell>& getCells();
-    
+    // 注意：直接修改不会同步占用位图
+    CellStorage& getCells();
+
     // 获取轨迹中网格单元的数量
     size_t getLength() const;
-    
-    // 获取指定索引处的网格单元
+
+    // 获取指定索引处的网格单元（带边界检查，越界抛出out_of_range）
     GridCell getCell(size_t index) const;
-    
+
+    // 不做边界检查的访问，供内部热点循环使用
+    const GridCell& operator[](size_t index) const { return cells.data()[index]; }
+
+    // 迭代器与只读视图
+    const GridCell* begin() const { return cells.data(); }
+    const GridCell* end() const { return cells.data() + cells.size(); }
+    CellSpan getSpan() const { return CellSpan(cells.data(), cells.size()); }
+
+    // 判断某个网格单元是否已在轨迹中（启用占用位图时为O(1)，位图范围之外查哈希集合）
+    bool contains(const GridCell& cell) const;
+
+    // 启用/关闭占用位图，启用时根据现有单元格重建
+    void enableOccupancy(bool enable = true);
+    bool isOccupancyEnabled() const;
+
     // 获取当前位置
     const GridCell& getCurrentCell() const;
-    
+
     // 设置当前位置
     void setCurrentCell(const GridCell& cell);
-    
+
     // 计算与另一条轨迹的相似度
     double calculateSimilarity(const Trajectory& other) const;
-    
+
     // 清空轨迹
     void clear();
-}; 
\ No newline at end of file
+};
@@ -0,0 +1,127 @@
+#include "Trajectory3.h"
+#include <algorithm>
+#include <stdexcept>
+using namespace std;
+
+Trajectory3::Trajectory3() {
+    // 构造函数初始化空轨迹
+    resetOccupancy();
+}
+
+int Trajectory3::occupancyIndex(const GridCell3& cell) {
+    // 把立方体坐标映射到位图下标，超出范围返回-1
+    int row = cell.getRow() - OCCUPANCY_MIN_COORD;
+    int col = cell.getCol() - OCCUPANCY_MIN_COORD;
+    int layer = cell.getLayer() - OCCUPANCY_MIN_COORD;
+    if (row < 0 || row >= OCCUPANCY_SIDE || col < 0 || col >= OCCUPANCY_SIDE ||
+        layer < 0 || layer >= OCCUPANCY_SIDE) {
+        return -1;
+    }
+    return (row * OCCUPANCY_SIDE + col) * OCCUPANCY_SIDE + layer;
+}
+
+void Trajectory3::markOccupied(const GridCell3& cell) {
+    int index = occupancyIndex(cell);
+    if (index < 0) {
+        occupancyOutside[cell]++;
+        return;
+    }
+    uint64_t bit = uint64_t(1) << (index & 63);
+    if (occupancy[index >> 6] & bit) {
+        occupancyDuplicates[cell]++;
+    }
+    occupancy[index >> 6] |= bit;
+}
+
+void Trajectory3::unmarkOccupied(const GridCell3& cell) {
+    // 计数减到0时删除，重复加入的单元格要全部移除后才清除位图
+    int index = occupancyIndex(cell);
+    unordered_map<GridCell3, uint32_t>& counts = index < 0 ? occupancyOutside : occupancyDuplicates;
+    unordered_map<GridCell3, uint32_t>::iterator it = counts.find(cell);
+    if (it != counts.end()) {
+        if (--it->second == 0) {
+            counts.erase(it);
+        }
+        return;
+    }
+    if (index >= 0) {
+        occupancy[index >> 6] &= ~(uint64_t(1) << (index & 63));
+    }
+}
+
+void Trajectory3::resetOccupancy() {
+    fill(occupancy, occupancy + OCCUPANCY_WORDS, 0);
+    occupancyDuplicates.clear();
+    occupancyOutside.clear();
+}
+
+void Trajectory3::addCell(const GridCell3& cell) {
+    cells.push_back(cell);
+    markOccupied(cell);
+    setCurrentCell(cell);
+}
+
+void Trajectory3::pop_back() {
+    // 移除最后一个网格单元（回溯时使用）
+    if (cells.empty()) {
+        return;
+    }
+    GridCell3 removed = cells.back();
+    cells.pop_back();
+    unmarkOccupied(removed);
+    if (!cells.empty()) {
+        setCurrentCell(cells.back());
+    }
+}
+
+const vector<GridCell3>& Trajectory3::getCells() const {
+    return cells;
+}
+
+size_t Trajectory3::getLength() const {
+    return cells.size();
+}
+
+GridCell3 Trajectory3::getCell(size_t index) const {
+    if (index >= cells.size()) {
+        throw std::out_of_range("Index out of range");
+    }
+    return cells[index];
+}
+
+bool Trajectory3::contains(const GridCell3& cell) const {
+    int index = occupancyIndex(cell);
+    if (index >= 0) {
+        return (occupancy[index >> 6] >> (index & 63)) & 1;
+    }
+    // 位图范围之外：只有合成后的最终轨迹会有越界单元格，多数时候哈希表为空
+    return !occupancyOutside.empty() && occupancyOutside.count(cell) != 0;
+}
+
+const GridCell3& Trajectory3::getCurrentCell() const {
+    return currentCell;
+}
+
+void Trajectory3::setCurrentCell(const GridCell3& cell) {
+    currentCell = cell;
+}
+
+double Trajectory3::calculateSimilarity(const Trajectory3& other) const {
+    size_t len = min(cells.size(), other.cells.size());
+    if (len < 2) {
+        return 0.0;
+    }
+    size_t matches = 0;
+    for (size_t i = 1; i < len; i++) {
+        if (cells[i] == other.cells[i]) {
+            matches++;
+        }
+    }
+    return static_cast<double>(matches) / (len - 1);
+}
+
+void Trajectory3::clear() {
+    cells.clear();
+    currentCell = GridCell3();
+    resetOccupancy();
+}
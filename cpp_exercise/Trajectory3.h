@@ -0,0 +1,73 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include "GridCell3.h"
+
+// 三维轨迹，接口与Trajectory一致
+// 三维的搜索空间增长很快，占用判断不做线性扫描：立方体内用打包的三维位图，
+// 立方体外的单元格（合成后的最终轨迹可能越出）和重复加入的单元格用哈希表计数
+class Trajectory3 {
+public:
+    // 占用位图覆盖的坐标范围（与生成三维轨迹时的立方体范围一致）
+    static const int OCCUPANCY_MIN_COORD = -7;
+    static const int OCCUPANCY_MAX_COORD = 7;
+
+private:
+    static const int OCCUPANCY_SIDE = OCCUPANCY_MAX_COORD - OCCUPANCY_MIN_COORD + 1;
+    static const int OCCUPANCY_WORDS = (OCCUPANCY_SIDE * OCCUPANCY_SIDE * OCCUPANCY_SIDE + 63) / 64;
+
+    std::vector<GridCell3> cells;   // 存储轨迹中的所有网格单元
+    GridCell3 currentCell;          // 当前位置
+
+    // 占用位图：按(行, 列, 层)展开，每格1位
+    uint64_t occupancy[OCCUPANCY_WORDS];
+    std::unordered_map<GridCell3, uint32_t> occupancyDuplicates; // 位图范围内重复加入的次数（不含第一次）
+    std::unordered_map<GridCell3, uint32_t> occupancyOutside;    // 位图范围之外的单元格及其加入次数
+
+    // 计算单元格在位图中的位置，超出范围返回-1
+    static int occupancyIndex(const GridCell3& cell);
+    void markOccupied(const GridCell3& cell);
+    void unmarkOccupied(const GridCell3& cell);
+    void resetOccupancy();
+
+public:
+    // 构造函数
+    Trajectory3();
+
+    // 添加一个网格单元到轨迹
+    void addCell(const GridCell3& cell);
+
+    // 移除最后一个网格单元，并把当前位置回退到新的末尾
+    void pop_back();
+
+    // 获取轨迹中所有网格单元
+    const std::vector<GridCell3>& getCells() const;
+
+    // 获取轨迹中网格单元的数量
+    size_t getLength() const;
+
+    // 获取指定索引处的网格单元（带边界检查，越界抛出out_of_range）
+    GridCell3 getCell(size_t index) const;
+
+    // 不做边界检查的访问
+    const GridCell3& operator[](size_t index) const { return cells[index]; }
+
+    // 迭代器
+    const GridCell3* begin() const { return cells.data(); }
+    const GridCell3* end() const { return cells.data() + cells.size(); }
+
+    // 判断某个网格单元是否已在轨迹中（O(1)）
+    bool contains(const GridCell3& cell) const;
+
+    // 获取/设置当前位置
+    const GridCell3& getCurrentCell() const;
+    void setCurrentCell(const GridCell3& cell);
+
+    // 计算与另一条轨迹的相似度（规则与二维相同：跳过起点，逐步比较；少于两个单元格时返回0）
+    double calculateSimilarity(const Trajectory3& other) const;
+
+    // 清空轨迹
+    void clear();
+};
@@ -0,0 +1,67 @@
+#include "TrajectorySoA.h"
+#include "SimilarityKernel.h"
+#include <algorithm>
+#include <stdexcept>
+using namespace std;
+
+TrajectorySoA::TrajectorySoA() {
+    // 构造空轨迹
+}
+
+TrajectorySoA::TrajectorySoA(const Trajectory& trajectory) {
+    assign(trajectory);
+}
+
+void TrajectorySoA::assign(const Trajectory& trajectory) {
+    clear();
+    reserve(trajectory.getLength());
+    for (const GridCell& cell : trajectory.getCells()) {
+        addCell(cell);
+    }
+}
+
+void TrajectorySoA::addCell(const GridCell& cell) {
+    rows.push_back(static_cast<int16_t>(cell.getRow()));
+    cols.push_back(static_cast<int16_t>(cell.getCol()));
+}
+
+size_t TrajectorySoA::getLength() const {
+    return rows.size();
+}
+
+GridCell TrajectorySoA::getCell(size_t index) const {
+    if (index >= rows.size()) {
+        throw std::out_of_range("Index out of range");
+    }
+    return GridCell(rows[index], cols[index]);
+}
+
+const int16_t* TrajectorySoA::getRows() const {
+    return rows.data();
+}
+
+const int16_t* TrajectorySoA::getCols() const {
+    return cols.data();
+}
+
+double TrajectorySoA::calculateSimilarity(const TrajectorySoA& other) const {
+    // 跳过起点，比较之后每一步是否重合
+    size_t length = min(rows.size(), other.rows.size());
+    if (length < 2) {
+        return 0.0;
+    }
+    size_t size = length - 1;
+    size_t matches = SimilarityKernel::countMatches(rows.data() + 1, cols.data() + 1,
+                                                    other.rows.data() + 1, other.cols.data() + 1, size);
+    return static_cast<double>(matches) / size;
+}
+
+void TrajectorySoA::reserve(size_t count) {
+    rows.reserve(count);
+    cols.reserve(count);
+}
+
+void TrajectorySoA::clear() {
+    rows.clear();
+    cols.clear();
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include "GridCell.h"
+#include "Trajectory.h"
+
+// 行列分离存储（结构数组）的轨迹，行坐标和列坐标各自连续存放
+// 用于离线批量评分，相似度计算可以一次比较多个单元格
+class TrajectorySoA {
+private:
+    std::vector<int16_t> rows;  // 所有单元格的行坐标
+    std::vector<int16_t> cols;  // 所有单元格的列坐标
+
+public:
+    // 构造函数
+    TrajectorySoA();
+    explicit TrajectorySoA(const Trajectory& trajectory);
+
+    // 由普通轨迹重建
+    void assign(const Trajectory& trajectory);
+
+    // 添加一个网格单元
+    void addCell(const GridCell& cell);
+
+    // 获取单元格数量
+    size_t getLength() const;
+
+    // 获取指定索引处的网格单元，越界抛出out_of_range
+    GridCell getCell(size_t index) const;
+
+    // 获取行、列坐标数组
+    const int16_t* getRows() const;
+    const int16_t* getCols() const;
+
+    // 计算与另一条轨迹的相似度，规则与Trajectory::calculateSimilarity一致（少于两个单元格时返回0，不输出）
+    double calculateSimilarity(const TrajectorySoA& other) const;
+
+    // 预留空间
+    void reserve(size_t count);
+
+    // 清空轨迹
+    void clear();
+};
@@ -0,0 +1,323 @@
+#include "TrajectoryStrategy.h"
+#include "GameObject.h"
+#include <chrono>
+#include <cmath>
+
+using namespace std;
+
+TrajectoryStrategy::TrajectoryStrategy(const string& strategyName)
+    : name(strategyName), calls(0), successes(0), nanoseconds(0) {}
+
+TrajectoryStrategy::~TrajectoryStrategy() {}
+
+const string& TrajectoryStrategy::getName() const {
+    return name;
+}
+
+bool TrajectoryStrategy::generate(GameObject& object, Trajectory& trajectory, int steps, TopologyKind topology) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    bool success = run(object, trajectory, steps, topology);
+    long long elapsed = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    calls.fetch_add(1, memory_order_relaxed);
+    successes.fetch_add(success ? 1 : 0, memory_order_relaxed);
+    nanoseconds.fetch_add(elapsed, memory_order_relaxed);
+    return success;
+}
+
+TrajectoryStrategy::Stats TrajectoryStrategy::getStats() const {
+    Stats stats;
+    stats.calls = calls.load(memory_order_relaxed);
+    stats.successes = successes.load(memory_order_relaxed);
+    stats.seconds = nanoseconds.load(memory_order_relaxed) * 1e-9;
+    return stats;
+}
+
+void TrajectoryStrategy::resetStats() {
+    calls = 0;
+    successes = 0;
+    nanoseconds = 0;
+}
+
+// 回溯、PERM：直接调用GameObject中的实现
+
+BacktrackStrategy::BacktrackStrategy() : TrajectoryStrategy("backtrack") {}
+
+bool BacktrackStrategy::run(GameObject& object, Trajectory& trajectory, int steps, TopologyKind topology) {
+    return object.generateTrajectoryBacktrack(trajectory, 0, steps, -1, topology);
+}
+
+PermStrategy::PermStrategy() : TrajectoryStrategy("perm") {}
+
+bool PermStrategy::run(GameObject& object, Trajectory& trajectory, int steps, TopologyKind topology) {
+    return object.generateTrajectoryPerm(trajectory, steps, topology);
+}
+
+// Lévy飞行
+
+LevyWalkStrategy::LevyWalkStrategy() : TrajectoryStrategy("levy") {}
+
+bool LevyWalkStrategy::run(GameObject& object, Trajectory& trajectory, int steps, TopologyKind topology) {
+    RandomEngine& random = object.getRandomEngine();
+    const BoardConfig& board = object.getBoard(topology);
+    const int count = getDirectionCount(topology);
+    const GridCell* directions = getDirections(topology);
+
+    int lastDir = -1;
+    int run = 0;  // 当前直行段还剩的步数
+    int freeDirs[8];
+    for (int i = 0; i < steps; i++) {
+        const GridCell& cell = trajectory.getCurrentCell();
+        int freeCount = 0;
+        bool straightFree = false;
+        for (int dir = 0; dir < count; dir++) {
+            GridCell next = cell + directions[dir];
+            if (board.contains(next) && !trajectory.contains(next)) {
+                freeDirs[freeCount++] = dir;
+                straightFree |= dir == lastDir;
+            }
+        }
+        if (freeCount == 0) {
+            // 走进死角，本次尝试失败
+            return false;
+        }
+        int dir;
+        if (run > 0 && straightFree) {
+            dir = lastDir;
+            run--;
+        } else {
+            // 换方向并抽取新的段长：L = floor(u^(-1/a))，u在(0, 1]内均匀分布
+            dir = freeDirs[random.nextInt(freeCount)];
+            double length = pow(1.0 - random.nextDouble(), -1.0 / RUN_EXPONENT);
+            run = static_cast<int>(min(length, static_cast<double>(steps))) - 1;
+        }
+        trajectory.addCell(cell + directions[dir]);
+        lastDir = dir;
+    }
+    return true;
+}
+
+// 查表
+
+TableLookupStrategy::TableLookupStrategy() : TrajectoryStrategy("table") {}
+
+TableLookupStrategy::~TableLookupStrategy() {
+    for (size_t i = 0; i < tables.size(); i++) {
+        delete tables[i];
+    }
+}
+
+const TableLookupStrategy::Table* TableLookupStrategy::getTable(TopologyKind topology, int steps) {
+    {
+        lock_guard<mutex> lock(tableMutex);
+        for (size_t i = 0; i < tables.size(); i++) {
+            if (tables[i]->topology == topology && tables[i]->steps == steps) {
+                return tables[i];
+            }
+        }
+    }
+
+    // 枚举可能很慢，在锁外进行，其他(拓扑, 步数)的查表不受影响
+    Table* table = new Table();
+    buildTable(*table, topology, steps);
+
+    lock_guard<mutex> lock(tableMutex);
+    for (size_t i = 0; i < tables.size(); i++) {
+        if (tables[i]->topology == topology && tables[i]->steps == steps) {
+            delete table;
+            return tables[i];
+        }
+    }
+    tables.push_back(table);
+    return table;
+}
+
+void TableLookupStrategy::buildTable(Table& table, TopologyKind topology, int steps) {
+    table.topology = topology;
+    table.steps = steps;
+    table.available = steps <= MAX_TABLE_STEPS;
+    if (!table.available) {
+        return;
+    }
+
+    // 从原点出发深度优先枚举，visited覆盖steps步内可能到达的范围；条数超过上限时放弃
+    const int count = getDirectionCount(topology);
+    const GridCell* directions = getDirections(topology);
+    int reach = steps;   // 各拓扑每步行、列坐标最多变化1（六方向以轴坐标存放）
+    int side = 2 * reach + 1;
+    vector<char> visited(static_cast<size_t>(side) * side, 0);
+    auto indexOf = [&](const GridCell& cell) {
+        return static_cast<size_t>(cell.getRow() + reach) * side + (cell.getCol() + reach);
+    };
+
+    vector<int> nextDir(steps + 1, 0);
+    vector<GridCell> path(steps + 1);
+    uint64_t code = 0;
+    int depth = 0;
+    path[0] = GridCell(0, 0);
+    visited[indexOf(path[0])] = 1;
+    while (depth >= 0) {
+        if (depth == steps) {
+            if (table.walks.size() >= MAX_TABLE_WALKS) {
+                table.available = false;
+                table.walks.clear();
+                table.walks.shrink_to_fit();
+                return;
+            }
+            table.walks.push_back(code);
+            // 回到上一层继续
+            visited[indexOf(path[depth])] = 0;
+            depth--;
+            continue;
+        }
+        if (nextDir[depth] == count) {
+            nextDir[depth] = 0;
+            if (depth > 0) {
+                visited[indexOf(path[depth])] = 0;
+            }
+            depth--;
+            continue;
+        }
+        int dir = nextDir[depth]++;
+        GridCell next = path[depth] + directions[dir];
+        if (visited[indexOf(next)]) {
+            continue;
+        }
+        visited[indexOf(next)] = 1;
+        code = (code & ((uint64_t(1) << (3 * depth)) - 1)) | (uint64_t(dir) << (3 * depth));
+        path[++depth] = next;
+    }
+}
+
+bool TableLookupStrategy::run(GameObject& object, Trajectory& trajectory, int steps, TopologyKind topology) {
+    const Table* table = getTable(topology, steps);
+    if (!table->available || table->walks.empty()) {
+        return false;
+    }
+    RandomEngine& random = object.getRandomEngine();
+    const BoardConfig& board = object.getBoard(topology);
+    const GridCell* directions = getDirections(topology);
+    const GridCell start = trajectory.getCurrentCell();
+    size_t walkCount = table->walks.size();
+
+    for (int attempt = 0; attempt < MAX_LOOKUP_TRIES; attempt++) {
+        uint64_t code = table->walks[random.nextInt(static_cast<int>(walkCount))];
+        // 先确认整条轨迹在棋盘内，再写入
+        GridCell cell = start;
+        bool fits = true;
+        for (int i = 0; i < steps && fits; i++) {
+            cell += directions[(code >> (3 * i)) & 7];
+            fits = board.contains(cell);
+        }
+        if (!fits) {
+            continue;
+        }
+        cell = start;
+        for (int i = 0; i < steps; i++) {
+            cell += directions[(code >> (3 * i)) & 7];
+            trajectory.addCell(cell);
+        }
+        return true;
+    }
+    return false;
+}
+
+// 之字形备用
+
+ZigZagStrategy::ZigZagStrategy() : TrajectoryStrategy("zigzag") {}
+
+bool ZigZagStrategy::run(GameObject& object, Trajectory& trajectory, int steps, TopologyKind topology) {
+    const BoardConfig& board = object.getBoard(topology);
+    const GridCell* directions = getDirections(topology);
+    const int count = getDirectionCount(topology);
+    // 两个交替的方向都朝行坐标增大的一侧，轨迹呈阶梯状，直到碰到边界才会反向
+    const int vertical = 3;
+    const int horizontal = topology == TOPOLOGY_HEX ? 4 : 1;
+    for (int i = 0; i < steps; i++) {
+        const GridCell& cell = trajectory.getCurrentCell();
+        GridCell step = directions[i % 2 == 0 ? vertical : horizontal];
+        GridCell next = cell + step;
+        if (!board.contains(next)) {
+            next = cell - step;
+        }
+        // 六方向的斜向移动可能两个方向都出界，改用任意一个留在棋盘内的方向
+        for (int dir = 0; dir < count && !board.contains(next); dir++) {
+            next = cell + directions[dir];
+        }
+        if (!board.contains(next)) {
+            return false;
+        }
+        trajectory.addCell(next);
+    }
+    return true;
+}
+
+// 注册表
+
+StrategyRegistry::StrategyRegistry() {
+    registerStrategy(new BacktrackStrategy());
+    registerStrategy(new PermStrategy());
+    registerStrategy(new LevyWalkStrategy());
+    registerStrategy(new TableLookupStrategy());
+    registerStrategy(new ZigZagStrategy());
+    defaultStrategy = strategies[0];
+}
+
+StrategyRegistry::~StrategyRegistry() {
+    for (size_t i = 0; i < strategies.size(); i++) {
+        delete strategies[i];
+    }
+}
+
+StrategyRegistry& StrategyRegistry::instance() {
+    static StrategyRegistry registry;
+    return registry;
+}
+
+bool StrategyRegistry::registerStrategy(TrajectoryStrategy* strategy) {
+    lock_guard<mutex> lock(registryMutex);
+    for (size_t i = 0; i < strategies.size(); i++) {
+        if (strategies[i]->getName() == strategy->getName()) {
+            delete strategy;
+            return false;
+        }
+    }
+    strategies.push_back(strategy);
+    return true;
+}
+
+TrajectoryStrategy* StrategyRegistry::find(const string& name) const {
+    lock_guard<mutex> lock(registryMutex);
+    for (size_t i = 0; i < strategies.size(); i++) {
+        if (strategies[i]->getName() == name) {
+            return strategies[i];
+        }
+    }
+    return nullptr;
+}
+
+vector<TrajectoryStrategy*> StrategyRegistry::getStrategies() const {
+    lock_guard<mutex> lock(registryMutex);
+    return strategies;
+}
+
+bool StrategyRegistry::assign(int mode, int minSteps, int maxSteps, const string& name) {
+    TrajectoryStrategy* strategy = find(name);
+    if (strategy == nullptr) {
+        return false;
+    }
+    lock_guard<mutex> lock(registryMutex);
+    Rule rule = {mode, minSteps, maxSteps, strategy};
+    rules.push_back(rule);
+    return true;
+}
+
+TrajectoryStrategy* StrategyRegistry::select(int mode, int steps) const {
+    lock_guard<mutex> lock(registryMutex);
+    for (size_t i = rules.size(); i > 0; i--) {
+        const Rule& rule = rules[i - 1];
+        if (rule.mode == mode && steps >= rule.minSteps && steps <= rule.maxSteps) {
+            return rule.strategy;
+        }
+    }
+    return defaultStrategy;
+}
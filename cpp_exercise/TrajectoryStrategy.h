@@ -0,0 +1,159 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Trajectory.h"
+#include "Topology.h"
+
+class GameObject;
+
+// 轨迹生成策略：从轨迹中已有的起点出发生成steps步，成功返回true
+// 同一个策略对象由所有GameObject共享，可能被多个线程同时调用，
+// 生成过程中的临时状态放在传入的GameObject里（随机数、回溯栈等），策略本身不保存
+class TrajectoryStrategy {
+public:
+    // 计时统计
+    struct Stats {
+        long calls;       // 调用次数
+        long successes;   // 成功次数
+        double seconds;   // 累计耗时
+    };
+
+private:
+    std::string name;
+    std::atomic<long> calls;
+    std::atomic<long> successes;
+    std::atomic<long long> nanoseconds;
+
+    TrajectoryStrategy(const TrajectoryStrategy&);
+    TrajectoryStrategy& operator=(const TrajectoryStrategy&);
+
+protected:
+    // 具体的生成算法
+    virtual bool run(GameObject& object, Trajectory& trajectory, int steps, TopologyKind topology) = 0;
+
+public:
+    explicit TrajectoryStrategy(const std::string& strategyName);
+    virtual ~TrajectoryStrategy();
+
+    const std::string& getName() const;
+
+    // 生成并累计调用次数、成功次数和耗时
+    bool generate(GameObject& object, Trajectory& trajectory, int steps, TopologyKind topology);
+
+    Stats getStats() const;
+    void resetStats();
+};
+
+// 随机回溯（迭代深度优先，带可达性剪枝），默认策略
+class BacktrackStrategy : public TrajectoryStrategy {
+public:
+    BacktrackStrategy();
+protected:
+    virtual bool run(GameObject& object, Trajectory& trajectory, int steps, TopologyKind topology) override;
+};
+
+// PERM采样，长轨迹下接近均匀分布
+class PermStrategy : public TrajectoryStrategy {
+public:
+    PermStrategy();
+protected:
+    virtual bool run(GameObject& object, Trajectory& trajectory, int steps, TopologyKind topology) override;
+};
+
+// Lévy飞行式的随机游走：直行的段长服从幂律分布，走进死角时本次失败、不回溯
+// 生成的轨迹长直段较多，速度快，但失败率随步数增加
+class LevyWalkStrategy : public TrajectoryStrategy {
+public:
+    // 段长分布P(L >= l) = l^(-RUN_EXPONENT)
+    static constexpr double RUN_EXPONENT = 1.5;
+
+    LevyWalkStrategy();
+protected:
+    virtual bool run(GameObject& object, Trajectory& trajectory, int steps, TopologyKind topology) override;
+};
+
+// 查表：第一次用到某个(拓扑, 步数)时枚举从原点出发的全部自回避轨迹，
+// 之后每次均匀抽取一条、平移到起点，放不进棋盘就重抽
+// 轨迹条数超过MAX_TABLE_WALKS的组合不建表，直接返回false
+class TableLookupStrategy : public TrajectoryStrategy {
+public:
+    static const size_t MAX_TABLE_WALKS = 1 << 20;
+    static const int MAX_TABLE_STEPS = 21;   // 每步3位编码进64位整数
+    static const int MAX_LOOKUP_TRIES = 64;
+
+private:
+    struct Table {
+        int topology;
+        int steps;
+        bool available;                // 条数超过上限时为false
+        std::vector<uint64_t> walks;   // 每条轨迹的方向编码，第i步占[3i, 3i+3)位
+    };
+    std::mutex tableMutex;         // 只保护tables的查找和插入，枚举时不持有
+    std::vector<Table*> tables;
+
+    // 枚举一个(拓扑, 步数)的全部轨迹，填好table的各个字段
+    static void buildTable(Table& table, TopologyKind topology, int steps);
+
+    // 取得一个(拓扑, 步数)的表，没有时在锁外枚举后插入；多个线程同时建同一张表时保留先插入的
+    const Table* getTable(TopologyKind topology, int steps);
+
+public:
+    TableLookupStrategy();
+    virtual ~TableLookupStrategy();
+protected:
+    virtual bool run(GameObject& object, Trajectory& trajectory, int steps, TopologyKind topology) override;
+};
+
+// 交替沿行、列方向移动的之字形轨迹，到边界时反向；不保证自回避，只作为其他策略都失败时的备用
+class ZigZagStrategy : public TrajectoryStrategy {
+public:
+    ZigZagStrategy();
+protected:
+    virtual bool run(GameObject& object, Trajectory& trajectory, int steps, TopologyKind topology) override;
+};
+
+// 策略注册表：按名字登记策略，并按游戏模式和步数选择策略
+// 内置backtrack、perm、levy、table、zigzag五种策略，没有匹配的规则时使用backtrack
+class StrategyRegistry {
+private:
+    // 模式为mode、步数在[minSteps, maxSteps]内时使用strategy
+    struct Rule {
+        int mode;
+        int minSteps;
+        int maxSteps;
+        TrajectoryStrategy* strategy;
+    };
+
+    mutable std::mutex registryMutex;
+    std::vector<TrajectoryStrategy*> strategies;
+    std::vector<Rule> rules;
+    TrajectoryStrategy* defaultStrategy;
+
+    StrategyRegistry();
+    ~StrategyRegistry();
+    StrategyRegistry(const StrategyRegistry&);
+    StrategyRegistry& operator=(const StrategyRegistry&);
+
+public:
+    // 全局唯一的注册表
+    static StrategyRegistry& instance();
+
+    // 登记一个策略（注册表接管所有权），同名的策略已存在时返回false且不登记
+    bool registerStrategy(TrajectoryStrategy* strategy);
+
+    // 按名字查找，不存在时返回nullptr
+    TrajectoryStrategy* find(const std::string& name) const;
+
+    // 所有已登记的策略（用于输出计时统计）
+    std::vector<TrajectoryStrategy*> getStrategies() const;
+
+    // 为模式mode（GameManager::GameMode）的某个步数范围指定策略，后指定的规则优先
+    // 名字不存在时返回false
+    bool assign(int mode, int minSteps, int maxSteps, const std::string& name);
+
+    // 选择模式mode、步数steps使用的策略
+    TrajectoryStrategy* select(int mode, int steps) const;
+};
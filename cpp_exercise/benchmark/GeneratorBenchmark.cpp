@@ -0,0 +1,198 @@
+// 轨迹生成器的微基准测试
+// 对generateTrajectoryBacktrack、generateTrajectory、calculateActualTrajectory、calculateSimilarity
+// 在不同拓扑、步数（10到2000）和种子下计时，以JSON输出每次操作的耗时、内存分配次数、
+// 备用策略的使用比例以及p50/p99延迟
+//
+// 用法：GeneratorBenchmark [每个配置的操作数倍率，默认1]
+#include "../GameObject.h"
+#include "../TrajectoryStrategy.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// 统计内存分配次数：替换全局的operator new/delete
+static atomic<long> allocationCount(0);
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
+
+namespace {
+
+const int STEP_COUNTS[] = {10, 50, 200, 1000, 2000};
+const uint64_t SEEDS[] = {1, 2, 3};
+const TopologyKind TOPOLOGIES[] = {TOPOLOGY_SQUARE, TOPOLOGY_HEX, TOPOLOGY_KING};
+
+const char* topologyName(TopologyKind topology) {
+    switch (topology) {
+        case TOPOLOGY_HEX: return "hex";
+        case TOPOLOGY_KING: return "king";
+        default: return "square";
+    }
+}
+
+// 能容纳steps步的棋盘：默认31格边长，长轨迹时放大到格子数至少为步数的16倍
+// （更密的棋盘上回溯会频繁走进死角，测到的主要是失败重试）
+// 六方向在边长三分之一的轴坐标范围内生成（见GameObject::getBoard），边长再放大三倍
+BoardConfig boardFor(int steps, TopologyKind topology) {
+    int scale = topology == TOPOLOGY_HEX ? 3 : 1;
+    int side = max(31, scale * static_cast<int>(ceil(sqrt(16.0 * steps))));
+    return BoardConfig::centered(side);
+}
+
+// 每个配置每个种子的操作数，步数越多越少；长轨迹单次可达秒级，保持至少5次
+int operationsFor(int steps, int scale) {
+    return max(5, 4000 / steps) * scale;
+}
+
+// 一组计时样本的汇总
+struct Result {
+    string benchmark;
+    TopologyKind topology;
+    int steps;
+    int boardSide;
+    vector<double> samples; // 每次操作的纳秒数
+    long allocations;
+    long fallbacks;
+};
+
+void printResult(const Result& result, bool last) {
+    vector<double> sorted = result.samples;
+    sort(sorted.begin(), sorted.end());
+    double total = 0;
+    for (size_t i = 0; i < sorted.size(); i++) {
+        total += sorted[i];
+    }
+    size_t n = sorted.size();
+    double p50 = sorted[n / 2];
+    double p99 = sorted[min(n - 1, static_cast<size_t>(ceil(n * 0.99)) - 1)];
+    printf("  {\"benchmark\": \"%s\", \"topology\": \"%s\", \"steps\": %d, \"board\": %d, \"seeds\": %zu, "
+           "\"ops\": %zu, \"ns_per_op\": %.1f, \"allocs_per_op\": %.2f, \"fallback_rate\": %.4f, "
+           "\"p50_ns\": %.1f, \"p99_ns\": %.1f}%s\n",
+           result.benchmark.c_str(), topologyName(result.topology), result.steps, result.boardSide,
+           sizeof(SEEDS) / sizeof(SEEDS[0]), n, total / n, static_cast<double>(result.allocations) / n,
+           static_cast<double>(result.fallbacks) / n, p50, p99, last ? "" : ",");
+}
+
+// 计时一次操作，返回纳秒数
+template <typename Operation>
+double timeOnce(Operation operation) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    operation();
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int scale = argc >= 2 ? max(1, atoi(argv[1])) : 1;
+    TrajectoryStrategy* fallback = StrategyRegistry::instance().find("zigzag");
+
+    vector<Result> results;
+    for (TopologyKind topology : TOPOLOGIES) {
+        for (int steps : STEP_COUNTS) {
+            BoardConfig board = boardFor(steps, topology);
+            int ops = operationsFor(steps, scale);
+            Result backtrack = {"generateTrajectoryBacktrack", topology, steps, board.getSide(), {}, 0, 0};
+            Result generate = {"generateTrajectory", topology, steps, board.getSide(), {}, 0, 0};
+            Result compose = {"calculateActualTrajectory", topology, steps, board.getSide(), {}, 0, 0};
+            Result similarity = {"calculateSimilarity", topology, steps, board.getSide(), {}, 0, 0};
+
+            for (uint64_t seed : SEEDS) {
+                GameObject object;
+                object.seed(seed);
+                object.setBoard(board);
+                object.setFallbackStrategy(fallback);
+
+                // 直接调用回溯：失败即需要备用方法
+                Trajectory trajectory;
+                trajectory.enableOccupancy();
+                for (int i = 0; i < ops; i++) {
+                    trajectory.clear();
+                    trajectory.addCell(GridCell(0, 0));
+                    bool success = true;
+                    long before = allocationCount.load(memory_order_relaxed);
+                    backtrack.samples.push_back(timeOnce([&]() {
+                        success = object.generateTrajectoryBacktrack(trajectory, 0, steps, -1, topology);
+                    }));
+                    backtrack.allocations += allocationCount.load(memory_order_relaxed) - before;
+                    backtrack.fallbacks += success ? 0 : 1;
+                }
+
+                // 完整的生成流程：多次尝试都失败时才会用到备用策略
+                for (int i = 0; i < ops; i++) {
+                    long fallbacksBefore = fallback->getStats().calls;
+                    long before = allocationCount.load(memory_order_relaxed);
+                    generate.samples.push_back(timeOnce([&]() {
+                        object.generateTrajectory(topology, steps);
+                    }));
+                    generate.allocations += allocationCount.load(memory_order_relaxed) - before;
+                    generate.fallbacks += fallback->getStats().calls - fallbacksBefore;
+                }
+
+                // 合成与相似度使用同一对轨迹
+                object.generateTrajectory(topology, steps);
+                object.generateRelativeTrajectory(steps, topology);
+                for (int i = 0; i < ops; i++) {
+                    long before = allocationCount.load(memory_order_relaxed);
+                    compose.samples.push_back(timeOnce([&]() {
+                        object.calculateActualTrajectory();
+                    }));
+                    compose.allocations += allocationCount.load(memory_order_relaxed) - before;
+                }
+                volatile double sink = 0;
+                for (int i = 0; i < ops; i++) {
+                    long before = allocationCount.load(memory_order_relaxed);
+                    similarity.samples.push_back(timeOnce([&]() {
+                        sink = sink + object.getActualTrajectory().calculateSimilarity(object.getfinalTrajectory());
+                    }));
+                    similarity.allocations += allocationCount.load(memory_order_relaxed) - before;
+                }
+            }
+            results.push_back(backtrack);
+            results.push_back(generate);
+            results.push_back(compose);
+            results.push_back(similarity);
+        }
+    }
+
+    printf("[\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        printResult(results[i], i + 1 == results.size());
+    }
+    printf("]\n");
+    return 0;
+}